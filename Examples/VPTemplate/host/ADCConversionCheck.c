@@ -0,0 +1,232 @@
+/******************************************************************************
+ * @file ADCConversionCheck.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host check of the calibrated conversion of the ADC channels
+ *
+ * @details Simulates devices with typical and limit factory calibration
+ * values at VDDA = 3.0 V, 3.3 V and 3.6 V with 12bit and 16bit digits. The
+ * VREFINT channel and the inputs are quantized like by the ADC.
+ *
+ * The conversion of all digits is compared with the formulas of
+ * adcCalculateConversion() in double precision. The rounded scale factor,
+ * the truncated product and the rounded offset limit the difference to
+ * 1.5 µV or 2 m°C.
+ *
+ * The supply voltage, voltages over the whole range and the temperature at
+ * 30 °C, 70 °C and 110 °C are compared with the true values. The error
+ * must be within the quantization of the VREFINT channel and the input
+ * (half a digit each) plus the error of the arithmetic. The exit code is 1
+ * if a value is out of its limit.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <math.h>
+#include <stdio.h>
+
+#include "ADCModule.h"
+#include "ADCConversion.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define CHECK_DEVICES           3               //!< Number of simulated calibrations
+#define CHECK_SUPPLIES          3               //!< Number of simulated supply voltages
+#define CHECK_VOLTAGE_STEPS     97              //!< Input voltages per supply voltage
+#define CHECK_ARITHMETIC_UV     1.5             //!< Max. error of the arithmetic in µV
+#define CHECK_ARITHMETIC_MDEG   2.0             //!< Max. error of the arithmetic in m°C
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t checkQuantize(double volts, double supplyVolts, int32_t resolution);
+static uint32_t checkLimit(const char* pName, double value, double expected, double limit);
+static uint32_t checkArithmetic(const ADC_Calibration_t* pCalibration, uint32_t vrefRaw, int32_t resolution,
+                                const ADC_Conversion_t* pConversion);
+static uint32_t checkDevice(const ADC_Calibration_t* pCalibration, double supplyVolts, int32_t resolution);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+// VREFINT 1.212 V, sensor 0.76 V at 30 °C with 2.5 mV/°C (typical) and the limits
+static const ADC_Calibration_t gDevices[CHECK_DEVICES] =
+{
+    { 1655, 1038, 1311 },
+    { 1623,  956, 1198 },
+    { 1679, 1126, 1440 }
+};
+
+static const double gSupplies[CHECK_SUPPLIES] = { 3.0, 3.3, 3.6 };
+
+static double gMaxSupplyError = 0.0;    // Largest relative error of the supply voltage
+static double gMaxTempError = 0.0;      // Largest error at 70 °C in °C
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t device = 0; device < CHECK_DEVICES; device++)
+    {
+        for (uint32_t supply = 0; supply < CHECK_SUPPLIES; supply++)
+        {
+            errors += checkDevice(&gDevices[device], gSupplies[supply], ADC_NATIVE_RESOLUTION);
+            errors += checkDevice(&gDevices[device], gSupplies[supply], ADC_MAX_RESOLUTION);
+        }
+    }
+
+    // Invalid measurements and calibrations are rejected
+    ADC_Conversion_t conversion;
+    ADC_Calibration_t invalid = { 1655, 1311, 1311 };
+
+    if (adcCalculateConversion(&gDevices[0], 0, &conversion) != ADC_ERR_INVALID_PARAM
+        || adcCalculateConversion(&invalid, 1500, &conversion) != ADC_ERR_INVALID_PARAM
+        || adcCalculateConversion(&gDevices[0], 1500, 0) != ADC_ERR_INVALID_PTR)
+    {
+        printf("invalid parameters are not rejected\n");
+        errors++;
+    }
+
+    printf("adc conversion: max. VDDA error %.3f %%, max. error at 70 degC %.3f degC\n",
+           gMaxSupplyError * 100.0, gMaxTempError);
+    printf("adc conversion: %u errors\n", errors);
+
+    return (errors == 0) ? 0 : 1;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Digits of a voltage (rounded and clipped like by the ADC)
+ */
+static int32_t checkQuantize(double volts, double supplyVolts, int32_t resolution)
+{
+    double digits = floor(volts / supplyVolts * (1 << resolution) + 0.5);
+    double maxDigits = (1 << resolution) - 1;
+
+    return (int32_t)((digits < 0.0) ? 0.0 : ((digits > maxDigits) ? maxDigits : digits));
+}
+
+/**
+ * @brief Compares a value with the expected value, prints the first errors
+ */
+static uint32_t checkLimit(const char* pName, double value, double expected, double limit)
+{
+    static uint32_t printed = 0;
+
+    if (fabs(value - expected) <= limit)
+        return 0;
+
+    if (printed++ < 5)
+        printf("%s: %.1f instead of %.1f (limit %.1f)\n", pName, value, expected, limit);
+
+    return 1;
+}
+
+/**
+ * @brief Conversion of all digits against the formulas in double precision
+ */
+static uint32_t checkArithmetic(const ADC_Calibration_t* pCalibration, uint32_t vrefRaw, int32_t resolution,
+                                const ADC_Conversion_t* pConversion)
+{
+    uint32_t errors = 0;
+    double tsSpan = pCalibration->tsCal2 - pCalibration->tsCal1;
+
+    for (int32_t digits = 0; digits < (1 << resolution); digits++)
+    {
+        double microVolts = ADC_CAL_VREF_MV * 1000.0 * pCalibration->vrefIntCal * digits
+                            / ((double)vrefRaw * (1 << ADC_CAL_RESOLUTION));
+        double milliDegrees = ADC_CAL_TEMP1 * 1000.0 + (ADC_CAL_TEMP2 - ADC_CAL_TEMP1) * 1000.0
+                              * ((double)digits * pCalibration->vrefIntCal / vrefRaw - pCalibration->tsCal1) / tsSpan;
+
+        errors += checkLimit("voltage", fixLinear(&pConversion->voltage, digits), microVolts, CHECK_ARITHMETIC_UV);
+        errors += checkLimit("vbat", fixLinear(&pConversion->vbat, digits), microVolts * ADC_VBAT_DIVIDER,
+                             CHECK_ARITHMETIC_UV);
+        errors += checkLimit("temperature", fixLinear(&pConversion->temperature, digits), milliDegrees,
+                             CHECK_ARITHMETIC_MDEG);
+    }
+
+    return errors;
+}
+
+/**
+ * @brief Conversion of one simulated device at one supply voltage and
+ * resolution
+ */
+static uint32_t checkDevice(const ADC_Calibration_t* pCalibration, double supplyVolts, int32_t resolution)
+{
+    uint32_t errors = 0;
+    ADC_Conversion_t conversion;
+
+    // The calibration values are exact 12bit digits at 3.0 V
+    double calVolts = ADC_CAL_VREF_MV / 1000.0 / (1 << ADC_CAL_RESOLUTION);
+    int32_t vrefRaw = checkQuantize(pCalibration->vrefIntCal * calVolts, supplyVolts, resolution);
+    double vrefError = 0.5 / vrefRaw;
+
+    if (adcCalculateConversion(pCalibration, vrefRaw, &conversion) != ADC_ERR_OK)
+    {
+        printf("VREFINT %d digits is rejected\n", vrefRaw);
+        return 1;
+    }
+
+    errors += checkArithmetic(pCalibration, vrefRaw, resolution, &conversion);
+
+    // Supply voltage, only the VREFINT measurement is quantized
+    double supplyMicroVolts = supplyVolts * 1e6;
+    int32_t measuredSupply = fixLinear(&conversion.voltage, 1 << resolution);
+    double supplyError = fabs(measuredSupply - supplyMicroVolts) / supplyMicroVolts;
+
+    errors += checkLimit("VDDA", measuredSupply, supplyMicroVolts, supplyMicroVolts * vrefError + CHECK_ARITHMETIC_UV);
+
+    if (supplyError > gMaxSupplyError)
+        gMaxSupplyError = supplyError;
+
+    // Voltages, half a digit of the input and the VREFINT error
+    double halfDigit = supplyMicroVolts / (1 << resolution) / 2.0;
+
+    for (uint32_t step = 0; step < CHECK_VOLTAGE_STEPS; step++)
+    {
+        double microVolts = supplyMicroVolts * (step + 0.5) / CHECK_VOLTAGE_STEPS;
+        int32_t digits = checkQuantize(microVolts / 1e6, supplyVolts, resolution);
+        double limit = halfDigit * (1.0 + vrefError) + microVolts * vrefError + CHECK_ARITHMETIC_UV;
+
+        errors += checkLimit("input", fixLinear(&conversion.voltage, digits), microVolts, limit);
+    }
+
+    // Temperature sensor, linear between the calibration points
+    double cal1Volts = pCalibration->tsCal1 * calVolts;
+    double slope = (pCalibration->tsCal2 - pCalibration->tsCal1) * calVolts / (ADC_CAL_TEMP2 - ADC_CAL_TEMP1);
+
+    for (int32_t degrees = ADC_CAL_TEMP1; degrees <= ADC_CAL_TEMP2; degrees += (ADC_CAL_TEMP2 - ADC_CAL_TEMP1) / 2)
+    {
+        double sensorVolts = cal1Volts + (degrees - ADC_CAL_TEMP1) * slope;
+        int32_t digits = checkQuantize(sensorVolts, supplyVolts, resolution);
+        double milliDegrees = fixLinear(&conversion.temperature, digits);
+        double limit = (halfDigit * (1.0 + vrefError) / 1e6 + sensorVolts * vrefError) / slope * 1000.0
+                       + CHECK_ARITHMETIC_MDEG;
+
+        errors += checkLimit("temperature sensor", milliDegrees, degrees * 1000.0, limit);
+
+        if (degrees == 70 && fabs(milliDegrees / 1000.0 - degrees) > gMaxTempError)
+            gMaxTempError = fabs(milliDegrees / 1000.0 - degrees);
+    }
+
+    return errors;
+}
@@ -0,0 +1,350 @@
+/******************************************************************************
+ * @file FilterBench.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host benchmark and accuracy check of the EMA filter
+ *
+ * @details Runs the shift path, the generic reciprocal path (per sample and
+ * as block), the dual 16bit filter and a naive implementation with one
+ * division per sample on the same input. Reported are the time (and on x86
+ * the TSC cycles) per sample, the deviation from a double precision EMA and
+ * the error after settling on a constant input.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Filter/Filter.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define BENCH_SAMPLES           (1 << 16)       //!< Number of input samples
+#define BENCH_REPEAT            200             //!< Number of runs over the input for the timing
+#define BENCH_SETTLE_SAMPLES    10000           //!< Number of samples of the constant input
+#define BENCH_SETTLE_VALUE      3000            //!< Constant input value
+
+#define BENCH_MODE_SAMPLE       0               //!< filterEMA() per sample
+#define BENCH_MODE_BLOCK        1               //!< filterEMABlock() on the whole buffer
+#define BENCH_MODE_DIV          2               //!< Naive division per sample
+#define BENCH_MODE_COUNT        3
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief Filter configuration under test
+ */
+typedef struct _BenchConfig
+{
+    const char* pName;                  //!< Name used in the report
+    int32_t scalingFactor;              //!< Scaling factor of the filter
+    int32_t alpha;                      //!< Scaled alpha of the filter
+} BenchConfig;
+
+/**
+ * @brief Naive EMA with one division per sample, for comparison
+ */
+typedef struct _NaiveEMA
+{
+    int32_t alpha;                      //!< Scaled alpha
+    int32_t scalingFactor;              //!< Scaling factor
+    int32_t previousValue;              //!< Last output
+} NaiveEMA;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t naiveEMA(NaiveEMA* pEMA, int32_t sensorValue);
+static uint64_t benchHostNs(void);
+static uint64_t benchCycles(void);
+static void benchConfig(const BenchConfig* pConfig);
+static int32_t benchDual(const BenchConfig* pConfig);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static int32_t gInput[BENCH_SAMPLES];   // Noisy 12bit ADC like input signal
+static int32_t gOutput[BENCH_SAMPLES];  // Output of the block filter
+static int32_t gConstant[BENCH_SETTLE_SAMPLES];         // Constant input for the settling
+
+// 16bit frames, 32bit aligned for the dual filter: input signal in both channels and output
+static union
+{
+    uint32_t words[BENCH_SAMPLES];
+    uint16_t dual[2 * BENCH_SAMPLES];
+} gDualInput, gDualOutput;
+
+static volatile int32_t gSink;          // Keeps the compiler from removing the filter calls
+
+static const BenchConfig gConfigs[] =
+{
+    { "1/16 (shift)",   16,     1 },
+    { "1/4 (shift)",    1024,   256 },
+    { "3/100 (recip)",  100,    3 },
+    { "0.1 (recip)",    1000,   100 },
+};
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    // Slow sine with noise around mid scale of a 12bit ADC
+    srand(1);
+    for (int32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        gInput[i] = 2048 + (int32_t)(1000.0 * sin(i * 0.001)) + (rand() % 201) - 100;
+        gDualInput.dual[2 * i] = (uint16_t)gInput[i];
+        gDualInput.dual[2 * i + 1] = (uint16_t)gInput[i];
+    }
+
+    for (int32_t i = 0; i < BENCH_SETTLE_SAMPLES; i++)
+    {
+        gConstant[i] = BENCH_SETTLE_VALUE;
+    }
+
+    printf("%-14s %-6s %9s %9s %10s %10s %8s\n", "alpha", "path", "ns/smp", "cyc/smp", "meanErr", "maxErr", "settle");
+
+    for (uint32_t i = 0; i < sizeof(gConfigs) / sizeof(gConfigs[0]); i++)
+    {
+        benchConfig(&gConfigs[i]);
+
+        if (benchDual(&gConfigs[i]) != FILTER_ERR_OK)
+        {
+            printf("%-14s %-6s rejected\n", gConfigs[i].pName, "dual");
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Naive EMA: y = (alpha * x + (S - alpha) * y) / S
+ */
+static int32_t naiveEMA(NaiveEMA* pEMA, int32_t sensorValue)
+{
+    pEMA->previousValue = (pEMA->alpha * sensorValue + (pEMA->scalingFactor - pEMA->alpha) * pEMA->previousValue)
+                        / pEMA->scalingFactor;
+
+    return pEMA->previousValue;
+}
+
+/**
+ * @brief Reads the monotonic host clock
+ */
+static uint64_t benchHostNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Reads the cycle counter of the host (0 if not available)
+ */
+static uint64_t benchCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Runs timing and accuracy check of one filter configuration, for
+ * the library filter (per sample and block) and the naive division
+ */
+static void benchConfig(const BenchConfig* pConfig)
+{
+    static const char* pModeNames[BENCH_MODE_COUNT] = { "", "block", "div" };
+    double alpha = (double)pConfig->alpha / pConfig->scalingFactor;
+
+    for (int32_t mode = 0; mode < BENCH_MODE_COUNT; mode++)
+    {
+        EMAFilterData_t ema = { 0 };
+        NaiveEMA naiveData = { pConfig->alpha, pConfig->scalingFactor, gInput[0] };
+
+        filterInitEMA(&ema, pConfig->scalingFactor, pConfig->alpha, true);
+
+        // Timing
+        uint64_t startNs = benchHostNs();
+        uint64_t startCycles = benchCycles();
+
+        for (int32_t r = 0; r < BENCH_REPEAT; r++)
+        {
+            if (mode == BENCH_MODE_BLOCK)
+            {
+                filterEMABlock(&ema, gInput, gOutput, BENCH_SAMPLES);
+                continue;
+            }
+
+            for (int32_t i = 0; i < BENCH_SAMPLES; i++)
+            {
+                gSink = (mode == BENCH_MODE_DIV) ? naiveEMA(&naiveData, gInput[i]) : filterEMA(&ema, gInput[i]);
+            }
+        }
+
+        double samples = (double)BENCH_REPEAT * BENCH_SAMPLES;
+        double nsPerSample = (benchHostNs() - startNs) / samples;
+        double cyclesPerSample = (benchCycles() - startCycles) / samples;
+
+        // Accuracy against the double precision EMA
+        filterResetEMA(&ema);
+        naiveData.previousValue = gInput[0];
+
+        if (mode == BENCH_MODE_BLOCK)
+            filterEMABlock(&ema, gInput, gOutput, BENCH_SAMPLES);
+
+        double reference = gInput[0];
+        double errorSum = 0.0;
+        double errorMax = 0.0;
+
+        for (int32_t i = 0; i < BENCH_SAMPLES; i++)
+        {
+            int32_t output;
+
+            if (mode == BENCH_MODE_BLOCK)
+                output = gOutput[i];
+            else if (mode == BENCH_MODE_DIV)
+                output = naiveEMA(&naiveData, gInput[i]);
+            else
+                output = filterEMA(&ema, gInput[i]);
+
+            if (i > 0)
+                reference += alpha * (gInput[i] - reference);
+
+            double error = output - reference;
+            errorSum += error;
+            if (fabs(error) > errorMax)
+                errorMax = fabs(error);
+        }
+
+        // Error after settling from 0 on a constant input
+        filterResetEMA(&ema);
+        filterEMA(&ema, 0);
+        naiveData.previousValue = 0;
+
+        int32_t output = 0;
+        if (mode == BENCH_MODE_BLOCK)
+        {
+            filterEMABlock(&ema, gConstant, gOutput, BENCH_SETTLE_SAMPLES);
+            output = gOutput[BENCH_SETTLE_SAMPLES - 1];
+        }
+        else
+        {
+            for (int32_t i = 0; i < BENCH_SETTLE_SAMPLES; i++)
+            {
+                output = (mode == BENCH_MODE_DIV) ? naiveEMA(&naiveData, BENCH_SETTLE_VALUE)
+                                                  : filterEMA(&ema, BENCH_SETTLE_VALUE);
+            }
+        }
+
+        const char* pPath = pModeNames[mode];
+        if (mode == BENCH_MODE_SAMPLE)
+            pPath = ema.isPowerOfTwo ? "shift" : "recip";
+
+        printf("%-14s %-6s %9.2f %9.2f %10.3f %10.3f %8d\n", pConfig->pName, pPath,
+            nsPerSample, cyclesPerSample, errorSum / BENCH_SAMPLES, errorMax, output - BENCH_SETTLE_VALUE);
+    }
+}
+
+/**
+ * @brief Runs timing and accuracy check of the dual 16bit filter, the
+ * time is given per sample of one channel
+ *
+ * @return FILTER_ERR_OK, or the error of the filter (e.g. for misaligned
+ * buffers), then nothing is reported
+ */
+static int32_t benchDual(const BenchConfig* pConfig)
+{
+    double alpha = (double)pConfig->alpha / pConfig->scalingFactor;
+    EMADualFilterData_t ema;
+    int32_t result = filterInitEMADual(&ema, pConfig->scalingFactor, pConfig->alpha);
+
+    if (result != FILTER_ERR_OK)
+        return result;
+
+    uint64_t startNs = benchHostNs();
+    uint64_t startCycles = benchCycles();
+
+    for (int32_t r = 0; r < BENCH_REPEAT && result == FILTER_ERR_OK; r++)
+    {
+        result = filterEMADual(&ema, gDualInput.dual, gDualOutput.dual, 2, BENCH_SAMPLES);
+    }
+
+    if (result != FILTER_ERR_OK)
+        return result;
+
+    double samples = 2.0 * BENCH_REPEAT * BENCH_SAMPLES;
+    double nsPerSample = (benchHostNs() - startNs) / samples;
+    double cyclesPerSample = (benchCycles() - startCycles) / samples;
+
+    filterInitEMADual(&ema, pConfig->scalingFactor, pConfig->alpha);
+    result = filterEMADual(&ema, gDualInput.dual, gDualOutput.dual, 2, BENCH_SAMPLES);
+
+    if (result != FILTER_ERR_OK)
+        return result;
+
+    double reference = gInput[0];
+    double errorSum = 0.0;
+    double errorMax = 0.0;
+
+    for (int32_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        if (i > 0)
+            reference += alpha * (gInput[i] - reference);
+
+        double error = gDualOutput.dual[2 * i + 1] - reference;
+        errorSum += error;
+        if (fabs(error) > errorMax)
+            errorMax = fabs(error);
+    }
+
+    // Settling from 0 on a constant input
+    static union
+    {
+        uint32_t words[BENCH_SETTLE_SAMPLES];
+        uint16_t dual[2 * BENCH_SETTLE_SAMPLES];
+    } constant;
+
+    for (int32_t i = 0; i < 2 * BENCH_SETTLE_SAMPLES; i++)
+    {
+        constant.dual[i] = (i < 2) ? 0 : BENCH_SETTLE_VALUE;
+    }
+
+    filterInitEMADual(&ema, pConfig->scalingFactor, pConfig->alpha);
+    result = filterEMADual(&ema, constant.dual, constant.dual, 2, BENCH_SETTLE_SAMPLES);
+
+    if (result != FILTER_ERR_OK)
+        return result;
+
+    printf("%-14s %-6s %9.2f %9.2f %10.3f %10.3f %8d\n", pConfig->pName, "dual",
+        nsPerSample, cyclesPerSample, errorSum / BENCH_SAMPLES, errorMax,
+        constant.dual[2 * BENCH_SETTLE_SAMPLES - 1] - BENCH_SETTLE_VALUE);
+
+    return FILTER_ERR_OK;
+}
@@ -0,0 +1,804 @@
+/******************************************************************************
+ * @file FilterCheck.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host check of the Filter library against reference models
+ *
+ * @details Every filter is compared with a straightforward reference (the
+ * definition of the filter, in double precision where the filter rounds).
+ * The input signals are pseudo random and split into blocks of random
+ * length, so the state handling across blocks is covered as well. The exit
+ * code is 1 if a result differs.
+ *
+ * Design macros: the series of FilterDesign.h must be within their stated
+ * error of exp() and tan(), the biquad coefficients and the EMA alpha must
+ * equal their definition with the C library from fc / fs = 1e-7 up to
+ * almost 0.5. The coefficients close to 1.0 must saturate instead of
+ * wrapping around.
+ *
+ * Q15 filters: the impulse response of a FIR filter must be the negated
+ * coefficients (an impulse of -1.0 is exact in Q15) and each output of a
+ * biquad must match a direct form 1 in double precision, calculated from
+ * the actual previous outputs, within the truncation bound of the
+ * accumulator (including saturation).
+ *
+ * Window filters: the moving average, the minimum/maximum and the median
+ * are compared with a brute force evaluation of the window for all window
+ * sizes 1 .. CHECK_MAX_WINDOW (median: odd sizes). The signal has negative
+ * values, duplicates, constant runs and ramps, each filter is reset in the
+ * middle of the signal and the running number of the min/max deque wraps
+ * around.
+ *
+ * CIC decimator: every output frame must equal the direct convolution with
+ * the sinc^N impulse response (N boxcars of the decimation ratio), shifted
+ * by the gain with rounding, for all orders and decimation shifts from 0 up
+ * to FILTER_CIC_MAX_GAIN_BITS. The input uses the full allowed magnitude,
+ * so the integrators wrap around; in a second pass they start at random
+ * values (only the first order output frames are then part of the
+ * transient).
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Filter/Filter.h"
+#include "Filter/FilterDesign.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define CHECK_SAMPLES           4000            //!< Number of input samples of each filter
+#define CHECK_DESIGN_STEPS      100000          //!< Arguments of the exp() and tan() series
+#define CHECK_DESIGN_MIN_RATIO  1e-7            //!< Lowest fc / fs of the design macros
+#define CHECK_DESIGN_RATIO_STEP 1.01            //!< Factor between two fc / fs of the design macros
+#define CHECK_DESIGN_EMA_SCALE  65536           //!< Scaling factor of the EMA alpha
+#define CHECK_MAX_BLOCK         37              //!< Max. length of a block of input samples
+#define CHECK_MAX_WINDOW        512             //!< Max. window size of the window filters
+#define CHECK_MEDIAN_FULL       101             //!< Median windows up to this size are checked with all samples
+#define CHECK_CIC_CHANNELS      3               //!< Number of channels of the CIC decimator bank
+#define CHECK_CIC_OUTPUTS       12              //!< Number of output frames of each CIC decimator (at least order + 3)
+#define CHECK_CIC_MAX_RESPONSE  (FILTER_CIC_MAX_ORDER * 4096)   //!< Length of the stored impulse response (order > 1)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t checkRandom(void);
+static uint32_t checkBlockLength(uint32_t remaining);
+static uint32_t checkQ15Filter(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput);
+static int32_t checkDesignQ15(double x);
+static uint32_t checkDesignCoefficients(const char* pName, double ratio, const int16_t* pCoefficients,
+                                        const double* pExpected, uint32_t count);
+static uint32_t checkDesign(void);
+static uint32_t checkFIRImpulse(void);
+static uint32_t checkQ15Biquad(void);
+static void checkWindowSignal(int32_t* pSignal, uint32_t count);
+static int checkCompare(const void* pA, const void* pB);
+static uint32_t checkMovingAverage(void);
+static uint32_t checkMinMax(void);
+static uint32_t checkMedian(void);
+static int32_t checkCICInput(uint32_t n, uint32_t channel, int32_t limit);
+static uint32_t checkCICConfig(uint8_t order, uint8_t decimationShift, bool randomStart);
+static uint32_t checkCIC(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gSeed = 1;              // State of the pseudo random numbers
+static int16_t gInputQ15[CHECK_SAMPLES];    // Input samples of the Q15 filters
+static int16_t gOutputQ15[CHECK_SAMPLES];   // Output samples of the Q15 filters
+static int32_t gSignal[CHECK_SAMPLES];      // Input samples of the window filters
+static int32_t gSorted[CHECK_MAX_WINDOW];   // Sorted window of the median reference
+static int64_t gResponse[CHECK_CIC_MAX_RESPONSE];   // Impulse response of the CIC decimator
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    errors += checkDesign();
+    errors += checkFIRImpulse();
+    errors += checkQ15Biquad();
+    errors += checkMovingAverage();
+    errors += checkMinMax();
+    errors += checkMedian();
+    errors += checkCIC();
+
+    printf("filters: %u errors\n", errors);
+
+    return (errors == 0) ? 0 : 1;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Pseudo random number (linear congruential generator)
+ */
+static uint32_t checkRandom(void)
+{
+    gSeed = gSeed * 1664525UL + 1013904223UL;
+
+    return gSeed >> 8;
+}
+
+/**
+ * @brief Random block length 1 .. CHECK_MAX_BLOCK, limited to the remaining
+ * samples
+ */
+static uint32_t checkBlockLength(uint32_t remaining)
+{
+    uint32_t length = 1 + checkRandom() % CHECK_MAX_BLOCK;
+
+    return (length < remaining) ? length : remaining;
+}
+
+/**
+ * @brief Filters CHECK_SAMPLES Q15 samples in blocks of random length
+ */
+static uint32_t checkQ15Filter(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t n = 0; n < CHECK_SAMPLES; )
+    {
+        uint32_t length = checkBlockLength(CHECK_SAMPLES - n);
+
+        if (filterQ15Block(pFilter, &pInput[n], &pOutput[n], length) != FILTER_ERR_OK)
+            errors++;
+
+        n += length;
+    }
+
+    return errors;
+}
+
+/**
+ * @brief Definition of FILTER_DESIGN_Q15() (scaled, saturated, rounded half
+ * away from zero)
+ */
+static int32_t checkDesignQ15(double x)
+{
+    double scaled = x * (32768.0 / (1 << FILTER_BIQUAD_GAIN));
+
+    scaled = (scaled > INT16_MAX) ? INT16_MAX : ((scaled < INT16_MIN) ? INT16_MIN : scaled);
+
+    return (int32_t)((scaled < 0.0) ? ceil(scaled - 0.5) : floor(scaled + 0.5));
+}
+
+/**
+ * @brief Compares the coefficients of a design macro with their definition
+ */
+static uint32_t checkDesignCoefficients(const char* pName, double ratio, const int16_t* pCoefficients,
+                                        const double* pExpected, uint32_t count)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        int32_t expected = checkDesignQ15(pExpected[k]);
+
+        if (pCoefficients[k] != expected)
+        {
+            if (errors++ < 5)
+                printf("%s fc/fs = %.3g: c[%u] = %d instead of %d\n", pName, ratio, k, pCoefficients[k], expected);
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * @brief Series and coefficients of FilterDesign.h against the C library
+ */
+static uint32_t checkDesign(void)
+{
+    // Evaluated at build time, the scaled a1 is 1.0 - 4.4e-7 and must not wrap to -1.0
+    static const int16_t lowCutoffA[2] = FILTER_BIQUAD_LOWPASS_A(CHECK_DESIGN_MIN_RATIO, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+    const double q = FILTER_BIQUAD_Q_BUTTERWORTH;
+    uint32_t errors = 0;
+    double expError = 0.0;
+    double expSmallError = 0.0;
+    double tanError = 0.0;
+
+    // exp(-x) up to pi (fc = fs / 2), tan(x) up to 1.5
+    for (uint32_t i = 0; i <= CHECK_DESIGN_STEPS; i++)
+    {
+        double x = FILTER_DESIGN_PI * i / CHECK_DESIGN_STEPS;
+        double small = (double)i / CHECK_DESIGN_STEPS;
+        double tanX = 1.5 * (i + 1) / (CHECK_DESIGN_STEPS + 1);
+
+        expError = fmax(expError, fabs(FILTER_DESIGN_EXP_NEG(x) / exp(-x) - 1.0));
+        expSmallError = fmax(expSmallError, fabs(FILTER_DESIGN_EXP_NEG_SMALL(small) - exp(-small)));
+        tanError = fmax(tanError, fabs(FILTER_DESIGN_TAN(tanX) / tan(tanX) - 1.0));
+    }
+
+    if (expError >= 1e-8 || expSmallError >= 3e-6 || tanError >= 1e-11)
+    {
+        printf("design series: exp %.2g, exp small %.2g, tan %.2g\n", expError, expSmallError, tanError);
+        errors++;
+    }
+
+    // Coefficients from 1e-7 up to almost fs / 2, including the saturated a1
+    for (double ratio = CHECK_DESIGN_MIN_RATIO; ratio < 0.49; ratio *= CHECK_DESIGN_RATIO_STEP)
+    {
+        const int16_t lowPassB[3] = FILTER_BIQUAD_LOWPASS_B(ratio, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+        const int16_t highPassB[3] = FILTER_BIQUAD_HIGHPASS_B(ratio, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+        const int16_t feedbackA[2] = FILTER_BIQUAD_LOWPASS_A(ratio, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+        double k = tan(FILTER_DESIGN_PI * ratio);
+        double n = 1.0 / (1.0 + k / q + k * k);
+        double lowPass[3] = { k * k * n, 2.0 * k * k * n, k * k * n };
+        double highPass[3] = { n, -2.0 * n, n };
+        double feedback[2] = { -2.0 * (k * k - 1.0) * n, -(1.0 - k / q + k * k) * n };
+        int32_t alpha = FILTER_EMA_ALPHA(ratio, 1.0, CHECK_DESIGN_EMA_SCALE);
+        int32_t expectedAlpha = (int32_t)floor(CHECK_DESIGN_EMA_SCALE * (1.0 - exp(-2.0 * FILTER_DESIGN_PI * ratio)) + 0.5);
+
+        errors += checkDesignCoefficients("low pass b", ratio, lowPassB, lowPass, 3);
+        errors += checkDesignCoefficients("high pass b", ratio, highPassB, highPass, 3);
+        errors += checkDesignCoefficients("biquad a", ratio, feedbackA, feedback, 2);
+
+        if (alpha != expectedAlpha)
+        {
+            if (errors++ < 5)
+                printf("EMA fc/fs = %.3g: alpha = %d instead of %d\n", ratio, alpha, expectedAlpha);
+        }
+    }
+
+    if (lowCutoffA[0] != INT16_MAX)
+    {
+        printf("biquad a at fc/fs = %.3g: { %d, %d }\n", CHECK_DESIGN_MIN_RATIO, lowCutoffA[0], lowCutoffA[1]);
+        errors++;
+    }
+
+    printf("design macros: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Impulse responses of FIR filters with all numbers of taps and
+ * gains, the impulse is repeated after the last tap
+ */
+static uint32_t checkFIRImpulse(void)
+{
+    uint32_t errors = 0;
+    int16_t coefficients[FILTER_Q15_MAX_TAPS];
+
+    for (uint32_t taps = FILTER_Q15_MIN_TAPS_B; taps <= FILTER_Q15_MAX_TAPS; taps++)
+    {
+        for (uint8_t gain = 0; gain <= FILTER_Q15_MAX_GAIN; gain++)
+        {
+            FilterQ15Config_t config = { FILTER_Q15_FIR, coefficients, 0, (uint8_t)taps, 0, gain };
+            FilterQ15Data_t filter;
+
+            // Includes the limits, -32768 saturates to 32767 in the response
+            for (uint32_t k = 0; k < taps; k++)
+            {
+                coefficients[k] = (k == 0) ? INT16_MIN : ((k == 1) ? INT16_MAX : (int16_t)checkRandom());
+            }
+
+            for (uint32_t n = 0; n < CHECK_SAMPLES; n++)
+            {
+                gInputQ15[n] = (n % (taps + 3) == 0) ? INT16_MIN : 0;
+            }
+
+            if (filterInitQ15(&filter, &config, 0) != FILTER_ERR_OK)
+            {
+                errors++;
+                continue;
+            }
+
+            errors += checkQ15Filter(&filter, gInputQ15, gOutputQ15);
+
+            for (uint32_t n = 0; n < CHECK_SAMPLES; n++)
+            {
+                uint32_t k = n % (taps + 3);
+                int64_t expected = (k < taps) ? -(int64_t)coefficients[k] * (1 << gain) : 0;
+
+                if (expected > INT16_MAX)
+                    expected = INT16_MAX;
+                if (expected < INT16_MIN)
+                    expected = INT16_MIN;
+
+                if (gOutputQ15[n] != expected)
+                {
+                    if (errors++ < 5)
+                        printf("FIR %u taps, gain %u: y[%u] = %d instead of %ld\n", taps, gain, n, gOutputQ15[n],
+                               (long)expected);
+                }
+            }
+        }
+    }
+
+    printf("Q15 FIR impulse responses: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Biquads from FilterDesign.h against a direct form 1 in double
+ * precision
+ *
+ * Each of the five products is truncated to 22 fractional bits and the sum
+ * is truncated to Q15, so the output is at most 5 * 2^(gain - 7) + 1 LSB
+ * below the exact value and never above it (before the saturation). The
+ * input is a full scale square wave with noise, the overshoot of the low
+ * pass saturates.
+ */
+static uint32_t checkQ15Biquad(void)
+{
+    static const int16_t lowPassB[3] = FILTER_BIQUAD_LOWPASS_B(0.05, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+    static const int16_t lowPassA[2] = FILTER_BIQUAD_LOWPASS_A(0.05, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+    static const int16_t highPassB[3] = FILTER_BIQUAD_HIGHPASS_B(0.01, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+    static const int16_t highPassA[2] = FILTER_BIQUAD_HIGHPASS_A(0.01, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+    static const FilterQ15Config_t configs[] =
+    {
+        { FILTER_Q15_IIR, lowPassB, lowPassA, 3, 2, FILTER_BIQUAD_GAIN },
+        { FILTER_Q15_IIR, highPassB, highPassA, 3, 2, FILTER_BIQUAD_GAIN },
+    };
+
+    uint32_t errors = 0;
+    uint32_t saturated = 0;
+
+    for (uint32_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        const FilterQ15Config_t* pConfig = &configs[c];
+        double bound = 5.0 * ldexp(1.0, pConfig->gain - 7) + 1.0;
+        FilterQ15Data_t filter;
+
+        for (uint32_t n = 0; n < CHECK_SAMPLES; n++)
+        {
+            int32_t value = ((n / 200) % 2 == 0) ? 30000 : -30000;
+
+            gInputQ15[n] = (int16_t)(value + (int32_t)(checkRandom() % 5535) - 2767);
+        }
+
+        if (filterInitQ15(&filter, pConfig, 0) != FILTER_ERR_OK)
+        {
+            errors++;
+            continue;
+        }
+
+        errors += checkQ15Filter(&filter, gInputQ15, gOutputQ15);
+
+        for (uint32_t n = 0; n < CHECK_SAMPLES; n++)
+        {
+            double sum = 0.0;
+
+            for (uint32_t k = 0; k < pConfig->countB; k++)
+            {
+                sum += (n >= k) ? (double)pConfig->pCoeffB[k] * gInputQ15[n - k] : 0.0;
+            }
+
+            for (uint32_t k = 1; k <= pConfig->countA; k++)
+            {
+                sum += (n >= k) ? (double)pConfig->pCoeffA[k - 1] * gOutputQ15[n - k] : 0.0;
+            }
+
+            double exact = ldexp(sum, pConfig->gain - 15);
+            double upper = (exact > INT16_MAX) ? INT16_MAX : ((exact < INT16_MIN) ? INT16_MIN : exact);
+            double lower = exact - bound;
+
+            lower = (lower > INT16_MAX) ? INT16_MAX : ((lower < INT16_MIN) ? INT16_MIN : lower);
+
+            if (exact > INT16_MAX || exact < INT16_MIN)
+                saturated++;
+
+            if (gOutputQ15[n] > upper || gOutputQ15[n] < lower)
+            {
+                if (errors++ < 5)
+                    printf("biquad %u: y[%u] = %d, exact %.3f\n", c, n, gOutputQ15[n], exact);
+            }
+        }
+    }
+
+    // The check of the saturation needs saturated outputs
+    if (saturated == 0)
+        errors++;
+
+    printf("Q15 biquads: %u errors, %u saturated outputs\n", errors, saturated);
+
+    return errors;
+}
+
+/**
+ * @brief Signal of the window filters (12bit signed): segments of random
+ * values, values from a small set (duplicates), constant runs and ramps
+ */
+static void checkWindowSignal(int32_t* pSignal, uint32_t count)
+{
+    int32_t value = 0;
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t random = checkRandom();
+
+        switch ((n / 61) % 4)
+        {
+            case 0:
+                value = (int32_t)(random % 4096) - 2048;
+                break;
+
+            case 1:
+                value = (int32_t)(random % 5) * 1000 - 2000;
+                break;
+
+            case 2:
+                if (random % 16 == 0)
+                    value = (int32_t)(random % 4096) - 2048;
+                break;
+
+            default:
+                value = (value < 2000) ? value + 37 : -2048;
+                break;
+        }
+
+        pSignal[n] = value;
+    }
+}
+
+/**
+ * @brief Comparison of two int32_t values for qsort()
+ */
+static int checkCompare(const void* pA, const void* pB)
+{
+    int32_t a = *(const int32_t*)pA;
+    int32_t b = *(const int32_t*)pB;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Moving average against the mean of the window, rounded half away
+ * from zero (the window is filled with the first value)
+ */
+static uint32_t checkMovingAverage(void)
+{
+    static int32_t buffer[CHECK_MAX_WINDOW];
+    uint32_t errors = 0;
+
+    for (uint32_t windowSize = 1; windowSize <= CHECK_MAX_WINDOW; windowSize++)
+    {
+        uint32_t samples = 3 * windowSize + 500;
+        MovingAverageFilterData_t filter;
+
+        checkWindowSignal(gSignal, samples);
+
+        if (filterInitMovingAverage(&filter, buffer, windowSize) != FILTER_ERR_OK)
+        {
+            errors++;
+            continue;
+        }
+
+        for (uint32_t n = 0, start = 0; n < samples; n++)
+        {
+            if (n == samples / 2)
+            {
+                filterResetMovingAverage(&filter);
+                start = n;
+            }
+
+            int64_t sum = 0;
+
+            for (uint32_t k = 0; k < windowSize; k++)
+            {
+                sum += (n - start >= k) ? gSignal[n - k] : gSignal[start];
+            }
+
+            int64_t magnitude = (sum < 0) ? -sum : sum;
+            int64_t mean = (magnitude + windowSize / 2) / windowSize;
+            int32_t expected = (int32_t)((sum < 0) ? -mean : mean);
+            int32_t output = filterMovingAverage(&filter, gSignal[n]);
+
+            if (output != expected)
+            {
+                if (errors++ < 5)
+                    printf("mean %u: y[%u] = %d instead of %d\n", windowSize, n, output, expected);
+            }
+        }
+    }
+
+    printf("moving average: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Minimum and maximum against a search of the window (which starts
+ * with the first value after a reset), with and without a wrap around of
+ * the running number
+ */
+static uint32_t checkMinMax(void)
+{
+    static MinMaxFilterEntry_t deque[CHECK_MAX_WINDOW];
+    uint32_t errors = 0;
+
+    for (uint32_t windowSize = 1; windowSize <= CHECK_MAX_WINDOW; windowSize++)
+    {
+        uint32_t samples = 3 * windowSize + 500;
+
+        checkWindowSignal(gSignal, samples);
+
+        for (uint32_t variant = 0; variant < 4; variant++)
+        {
+            FilterExtremum_t extremum = ((variant & 1) == 0) ? FILTER_MINIMUM : FILTER_MAXIMUM;
+            MinMaxFilterData_t filter;
+
+            if (filterInitMinMax(&filter, deque, windowSize, extremum) != FILTER_ERR_OK)
+            {
+                errors++;
+                continue;
+            }
+
+            // The running number wraps around in the first half of the signal
+            if (variant >= 2)
+                filter.sequence = UINT32_MAX - windowSize;
+
+            for (uint32_t n = 0, start = 0; n < samples; n++)
+            {
+                if (n == samples / 2)
+                {
+                    filterResetMinMax(&filter);
+                    start = n;
+                }
+
+                int32_t expected = gSignal[n];
+
+                for (uint32_t k = 1; k < windowSize && n - start >= k; k++)
+                {
+                    int32_t value = gSignal[n - k];
+
+                    if ((extremum == FILTER_MINIMUM) ? (value < expected) : (value > expected))
+                        expected = value;
+                }
+
+                int32_t output = filterMinMax(&filter, gSignal[n]);
+
+                if (output != expected)
+                {
+                    if (errors++ < 5)
+                        printf("%s %u: y[%u] = %d instead of %d\n", (extremum == FILTER_MINIMUM) ? "min" : "max",
+                               windowSize, n, output, expected);
+                }
+            }
+        }
+    }
+
+    printf("minimum/maximum: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Median against the middle element of the sorted window (the
+ * window is filled with the first value), large windows with less samples
+ */
+static uint32_t checkMedian(void)
+{
+    static int32_t buffer[FILTER_MEDIAN_BUFFER_SIZE(CHECK_MAX_WINDOW)];
+    uint32_t errors = 0;
+
+    for (uint32_t windowSize = 1; windowSize < CHECK_MAX_WINDOW; windowSize += 2)
+    {
+        uint32_t samples = (windowSize <= CHECK_MEDIAN_FULL) ? 3 * windowSize + 500 : 2 * windowSize + 50;
+        MedianFilterData_t filter;
+
+        checkWindowSignal(gSignal, samples);
+
+        if (filterInitMedian(&filter, buffer, windowSize) != FILTER_ERR_OK)
+        {
+            errors++;
+            continue;
+        }
+
+        for (uint32_t n = 0, start = 0; n < samples; n++)
+        {
+            if (n == samples / 2)
+            {
+                filterResetMedian(&filter);
+                start = n;
+            }
+
+            for (uint32_t k = 0; k < windowSize; k++)
+            {
+                gSorted[k] = (n - start >= k) ? gSignal[n - k] : gSignal[start];
+            }
+
+            qsort(gSorted, windowSize, sizeof(gSorted[0]), checkCompare);
+
+            int32_t expected = gSorted[windowSize / 2];
+            int32_t output = filterMedian(&filter, gSignal[n]);
+
+            if (output != expected)
+            {
+                if (errors++ < 5)
+                    printf("median %u: y[%u] = %d instead of %d\n", windowSize, n, output, expected);
+            }
+        }
+
+        // Large windows only every 16th size
+        if (windowSize > CHECK_MEDIAN_FULL)
+            windowSize += 30;
+    }
+
+    printf("median: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Input sample n of a CIC channel (-limit .. limit, every 8th sample
+ * is one of the limits), calculated from the index so long signals need no
+ * buffer
+ */
+static int32_t checkCICInput(uint32_t n, uint32_t channel, int32_t limit)
+{
+    uint32_t hash = (n * 2654435761UL) ^ (channel * 0x9E3779B9UL);
+
+    hash ^= hash >> 15;
+    hash *= 0x85EBCA6BUL;
+    hash ^= hash >> 13;
+
+    if ((hash & 7) == 0)
+        return ((hash & 8) != 0) ? limit : -limit;
+
+    return (int32_t)(hash % (2 * (uint32_t)limit + 1)) - limit;
+}
+
+/**
+ * @brief One CIC decimator configuration, the frames are passed in blocks
+ * of random length and the last output frame of each block is compared
+ */
+static uint32_t checkCICConfig(uint8_t order, uint8_t decimationShift, bool randomStart)
+{
+    static int32_t frames[CHECK_MAX_BLOCK * CHECK_CIC_CHANNELS];
+    uint32_t ratio = 1UL << decimationShift;
+    uint32_t gainShift = order * decimationShift;
+    uint32_t length = order * (ratio - 1) + 1;
+    uint32_t channels = (ratio > 4096) ? 1 : CHECK_CIC_CHANNELS;
+    uint32_t outputs = (ratio > 4096) ? order + 3 : CHECK_CIC_OUTPUTS;
+    int32_t limit = (int32_t)((1UL << (31 - gainShift)) - 1);
+    uint32_t errors = 0;
+    CICFilterBank_t bank;
+
+    // Impulse response: convolution of order boxcars of the ratio (only
+    // stored for order > 1, the response of order 1 is the boxcar itself)
+    if (order > 1)
+    {
+        for (uint32_t j = 0; j < length; j++)
+        {
+            gResponse[j] = (j < ratio) ? 1 : 0;
+        }
+
+        for (uint32_t stage = 1; stage < order; stage++)
+        {
+            for (uint32_t j = length; j-- > 0; )
+            {
+                int64_t sum = 0;
+
+                for (uint32_t i = 0; i < ratio && i <= j; i++)
+                {
+                    sum += gResponse[j - i];
+                }
+
+                gResponse[j] = sum;
+            }
+        }
+    }
+
+    if (filterInitCICBank(&bank, channels, order, decimationShift) != FILTER_ERR_OK)
+        return 1;
+
+    if (randomStart == true)
+    {
+        for (uint32_t k = 0; k < order; k++)
+        {
+            for (uint32_t c = 0; c < channels; c++)
+            {
+                bank.integrator[k][c] = (checkRandom() << 8) ^ checkRandom();
+            }
+        }
+    }
+
+    uint32_t total = outputs * ratio;
+
+    for (uint32_t n = 0; n < total; )
+    {
+        uint32_t blockLength = checkBlockLength(total - n);
+
+        for (uint32_t i = 0; i < blockLength; i++)
+        {
+            for (uint32_t c = 0; c < channels; c++)
+            {
+                frames[i * channels + c] = checkCICInput(n + i, c, limit);
+            }
+        }
+
+        int32_t completed = filterCICBank(&bank, frames, blockLength);
+        uint32_t output = (n + blockLength) / ratio;
+
+        n += blockLength;
+
+        if (completed != (int32_t)(output - (n - blockLength) / ratio))
+        {
+            errors++;
+            continue;
+        }
+
+        // With random integrators the first order outputs are the transient
+        if (completed == 0 || (randomStart == true && output <= order))
+            continue;
+
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            int64_t sum = 0;
+            uint32_t last = output * ratio - 1;
+
+            for (uint32_t j = 0; j < length && j <= last; j++)
+            {
+                int64_t weight = (order > 1) ? gResponse[j] : 1;
+
+                sum += weight * checkCICInput(last - j, c, limit);
+            }
+
+            int32_t expected = (int32_t)((sum + ((gainShift > 0) ? (1LL << (gainShift - 1)) : 0)) >> gainShift);
+
+            if (bank.output[c] != expected)
+            {
+                if (errors++ < 5)
+                    printf("CIC order %u, shift %u: y[%u][%u] = %d instead of %d\n", order, decimationShift, output, c,
+                           bank.output[c], expected);
+            }
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * @brief CIC decimators of all orders, with decimation shifts up to 8 and
+ * the max. gain
+ */
+static uint32_t checkCIC(void)
+{
+    uint32_t errors = 0;
+
+    for (uint8_t order = 1; order <= FILTER_CIC_MAX_ORDER; order++)
+    {
+        uint8_t maxShift = FILTER_CIC_MAX_GAIN_BITS / order;
+
+        for (uint8_t shift = 0; shift <= maxShift; shift++)
+        {
+            if (shift > 8 && shift < maxShift)
+                continue;
+
+            errors += checkCICConfig(order, shift, false);
+            errors += checkCICConfig(order, shift, true);
+        }
+
+        // The gain beyond FILTER_CIC_MAX_GAIN_BITS is rejected
+        CICFilterBank_t bank;
+        if (filterInitCICBank(&bank, 1, order, maxShift + 1) != FILTER_ERR_INVALID_PARAM)
+            errors++;
+    }
+
+    printf("CIC decimator: %u errors\n", errors);
+
+    return errors;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file FilterKernelBench.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host driver of the filter kernel benchmark (src/Bench)
+ *
+ * @details Runs the same kernels and signals as the benchmark firmware and
+ * prints the results in the same format. The cycles are read from the TSC
+ * (x86 only), the checksums must match the ones of the target for every
+ * build profile. The comparison of the Q15 backends is run with the
+ * software backend in place of the FMAC, the exit code is 1 if an output
+ * sample differs.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Bench/FilterBenchmark.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#ifndef BUILD_PROFILE
+#define BUILD_PROFILE           "host"          //!< Name of the build profile (set by the Makefile)
+#endif
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t benchCycles(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static FilterBenchResult gResults[FILTER_BENCH_MAX_KERNELS];   // Results of the kernels
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    uint32_t resultCount = filterBenchRun(benchCycles, gResults, FILTER_BENCH_MAX_KERNELS);
+
+    printf("Filter benchmark, profile %s, %d samples\n", BUILD_PROFILE, FILTER_BENCH_SAMPLES);
+    printf("%-12s %10s %10s %10s\n", "kernel", "cycles", "cyc/smp", "checksum");
+
+    for (uint32_t i = 0; i < resultCount; i++)
+    {
+        printf("%-12s %10u %7u.%02u   %08x\n", gResults[i].pName, gResults[i].cycles,
+            gResults[i].cyclesPerSample100 / 100, gResults[i].cyclesPerSample100 % 100, gResults[i].checksum);
+    }
+
+    // No FMAC on the host, the software backend is compared with itself
+    uint32_t backendCount = filterBenchRunQ15Backend(benchCycles, filterQ15Software, gResults, FILTER_BENCH_MAX_KERNELS);
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < backendCount; i++)
+    {
+        mismatches += gResults[i].mismatchCount;
+    }
+
+    printf("Q15 backend check: %u kernels, %u differing samples\n", backendCount, mismatches);
+
+    return (mismatches == 0) ? 0 : 1;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Reads the lower 32bit of the cycle counter of the host (0 if not
+ * available)
+ */
+static uint32_t benchCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
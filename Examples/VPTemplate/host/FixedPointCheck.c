@@ -0,0 +1,228 @@
+/******************************************************************************
+ * @file FixedPointCheck.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host check of the fixed-point math library
+ *
+ * @details Compares the portable versions of the FixedPoint functions with
+ * the definition of the corresponding Cortex-M4 instructions (exhaustive
+ * for the Q15 operations, pseudo random operands including the limits for
+ * Q31) and measures the error of the reciprocal and the square roots. The
+ * exit code is 1 if a result differs.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FixedPoint/FixedPoint.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define CHECK_RANDOM_OPERANDS   2000000         //!< Number of random Q31 operand pairs
+#define CHECK_SQRT_STEP         997             //!< Step of the Q31 square root check above 2^21
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int64_t checkSaturate(int64_t x, int64_t min, int64_t max);
+static int32_t checkRandomQ31(uint32_t i);
+static uint32_t checkQ15(void);
+static uint32_t checkQ31(void);
+static uint32_t checkReciprocal(void);
+static uint32_t checkSqrt(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gSeed = 1;              // State of the pseudo random operands
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    uint32_t errors = 0;
+
+    errors += checkQ15();
+    errors += checkQ31();
+    errors += checkReciprocal();
+    errors += checkSqrt();
+
+    printf("fixed point: %u errors\n", errors);
+
+    return (errors == 0) ? 0 : 1;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Clips a value to min .. max (definition of the saturation)
+ */
+static int64_t checkSaturate(int64_t x, int64_t min, int64_t max)
+{
+    return (x < min) ? min : ((x > max) ? max : x);
+}
+
+/**
+ * @brief Q31 operand, the first ones are the limits, then pseudo random
+ */
+static int32_t checkRandomQ31(uint32_t i)
+{
+    static const int32_t limits[] = { INT32_MIN, INT32_MIN + 1, -1, 0, 1, INT32_MAX - 1, INT32_MAX };
+
+    if (i < sizeof(limits) / sizeof(limits[0]))
+        return limits[i];
+
+    gSeed = gSeed * 1664525UL + 1013904223UL;
+
+    return (int32_t)gSeed;
+}
+
+/**
+ * @brief Q15 add, subtract, multiply, MAC and the dual operations for all
+ * operand pairs
+ */
+static uint32_t checkQ15(void)
+{
+    uint32_t errors = 0;
+
+    for (int32_t a = INT16_MIN; a <= INT16_MAX; a++)
+    {
+        for (int32_t b = INT16_MIN; b <= INT16_MAX; b++)
+        {
+            int32_t sum = (int32_t)checkSaturate(a + b, INT16_MIN, INT16_MAX);
+            int32_t difference = (int32_t)checkSaturate(a - b, INT16_MIN, INT16_MAX);
+            int32_t product = (int32_t)checkSaturate((a * b) >> 15, INT16_MIN, INT16_MAX);
+            int32_t mac = (int32_t)checkSaturate((int64_t)0x3FFFFFFF + a * b, INT32_MIN, INT32_MAX);
+
+            uint32_t packedA = fixPack16(a, b);
+            uint32_t packedB = fixPack16(b, a);
+            uint32_t dualSum = ((uint32_t)(uint16_t)sum) | ((uint32_t)(uint16_t)sum << 16);
+            uint32_t dualMac = 12345U + (uint32_t)(a * b) + (uint32_t)(b * a);
+
+            if (fixAddQ15(a, b) != sum || fixSubQ15(a, b) != difference || fixMulQ15(a, b) != product
+                || fixMacQ15(0x3FFFFFFF, a, b) != mac || fixDualAddQ15(packedA, packedB) != dualSum
+                || fixDualMacQ15(packedA, packedB, 12345U) != dualMac)
+            {
+                if (errors++ < 5)
+                    printf("Q15 error for %d, %d\n", a, b);
+            }
+        }
+    }
+
+    printf("Q15 operations: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Q31 add, subtract, multiply and MAC with 128bit reference
+ */
+static uint32_t checkQ31(void)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < CHECK_RANDOM_OPERANDS; i++)
+    {
+        int32_t a = checkRandomQ31(i % 64);
+        int32_t b = checkRandomQ31(i);
+
+        int64_t sum = checkSaturate((int64_t)a + b, INT32_MIN, INT32_MAX);
+        int64_t difference = checkSaturate((int64_t)a - b, INT32_MIN, INT32_MAX);
+        int64_t product = checkSaturate((int64_t)(((__int128)a * b) >> 31), INT32_MIN, INT32_MAX);
+        int64_t mac = (int64_t)((__int128)a * b + 7);
+
+        if (fixAddQ31(a, b) != sum || fixSubQ31(a, b) != difference || fixMulQ31(a, b) != product
+            || fixMacQ31(7, a, b) != mac || fixQ62ToQ31(fixMacQ31(0, a, b)) != product
+            || fixCountLeadingZeros((uint32_t)a) != (uint32_t)(a == 0 ? 32 : __builtin_clz((uint32_t)a)))
+        {
+            if (errors++ < 5)
+                printf("Q31 error for %d, %d\n", a, b);
+        }
+    }
+
+    printf("Q31 operations: %u errors\n", errors);
+
+    return errors;
+}
+
+/**
+ * @brief Max. error of the reciprocal mantissa (must be <= 2 LSB)
+ */
+static uint32_t checkReciprocal(void)
+{
+    double errorMax = 0.0;
+
+    for (int64_t x = 1; x <= INT32_MAX; x += (x < 1000000) ? 1 : x / 100000)
+    {
+        int32_t exponent = 0;
+        int32_t mantissa = fixReciprocalQ31((int32_t)x, &exponent);
+
+        // 1 / (x / 2^31) / 2^exponent as Q31
+        double reference = ldexp(2147483648.0 / (double)x, 31 - exponent);
+        if (reference > INT32_MAX)
+            reference = INT32_MAX;
+
+        if (fabs(mantissa - reference) > errorMax)
+            errorMax = fabs(mantissa - reference);
+    }
+
+    printf("reciprocal: max. error %.2f LSB\n", errorMax);
+
+    return (errorMax <= 2.0) ? 0 : 1;
+}
+
+/**
+ * @brief Square roots must be exactly rounded down
+ */
+static uint32_t checkSqrt(void)
+{
+    uint32_t errors = 0;
+
+    for (int64_t x = 0; x <= INT32_MAX; x += (x < (1 << 21)) ? 1 : CHECK_SQRT_STEP)
+    {
+        uint64_t value = (uint64_t)x << 31;
+        uint64_t root = (uint64_t)fixSqrtQ31((int32_t)x);
+
+        if (root * root > value || (root + 1) * (root + 1) <= value)
+            errors++;
+    }
+
+    for (int32_t x = 0; x <= INT16_MAX; x++)
+    {
+        uint64_t value = (uint64_t)x << 15;
+        uint64_t root = (uint64_t)fixSqrtQ15((int16_t)x);
+
+        if (root * root > value || (root + 1) * (root + 1) <= value)
+            errors++;
+    }
+
+    for (uint64_t x = 0; x <= UINT32_MAX; x += (x < (1 << 21)) ? 1 : CHECK_SQRT_STEP * 2)
+    {
+        uint64_t root = fixSqrtU32((uint32_t)x);
+
+        if (root * root > x || (root + 1) * (root + 1) <= x)
+            errors++;
+    }
+
+    printf("square roots: %u errors\n", errors);
+
+    return errors;
+}
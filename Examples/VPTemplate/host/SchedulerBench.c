@@ -0,0 +1,384 @@
+/******************************************************************************
+ * @file SchedulerBench.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host benchmark of the cooperative scheduler with a virtual clock
+ *
+ * @details The scheduler module is built for the host and reads its HAL tick
+ * and cycle counter from a virtual clock in nanoseconds. The synthetic tasks
+ * don't do any work, they only advance the virtual clock by their cost. The
+ * super loop of main_app.c is modelled with a tickless idle, which jumps to
+ * the next release. So hours of operation are simulated in seconds.
+ *
+ * Reported are the host time spent in schedCycle() (dispatch overhead), the
+ * release jitter distribution in microseconds and the missed deadlines
+ * (finish after the next release) of every task.
+ *
+ * The virtual HAL tick starts one minute before its 32bit wrap around, so
+ * each run also covers the wrap.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Scheduler.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define BENCH_NS_PER_TICK       1000000ULL      //!< Length of a HAL tick (1ms)
+#define BENCH_CPU_MHZ           128ULL          //!< Simulated core clock for the cycle counter
+#define BENCH_START_TICK        (UINT32_MAX - 60000UL)  //!< Start one minute before the tick wrap around
+
+#define BENCH_HIST_BUCKET_US    50              //!< Width of a jitter histogram bucket in us
+#define BENCH_HIST_BUCKETS      1000            //!< Number of buckets (last one collects the rest)
+
+#define BENCH_SPREAD_DELAY      1000            //!< Ticks until the phases are spread (-S)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief Synthetic task of the benchmark
+ */
+typedef struct _BenchTask
+{
+    const char* pName;                  //!< Name used in the report
+    uint32_t period;                    //!< Period in HAL ticks
+    uint32_t costUs;                    //!< Nominal execution time in us
+    uint32_t variationPercent;          //!< Random variation of the execution time (+/-)
+    uint32_t spikePermille;             //!< Probability of a spike (per mille of the executions)
+    uint32_t spikeUs;                   //!< Execution time of a spike in us
+
+    int32_t taskID;                     //!< ID in the scheduler
+    uint32_t releaseTick;               //!< Release tick of the current execution
+    uint64_t missedDeadlines;           //!< Number of executions which finished after the next release
+    uint64_t hist[BENCH_HIST_BUCKETS];  //!< Jitter histogram
+} BenchTask;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t benchGetHALTick(void);
+static uint32_t benchGetCycleCount(void);
+static uint32_t benchRandom(void);
+static void benchRunTask(int32_t index);
+static void benchTask0(void);
+static void benchTask1(void);
+static void benchTask2(void);
+static void benchTask3(void);
+static void benchTask4(void);
+static uint64_t benchHostNs(void);
+static uint32_t benchPercentile(const BenchTask* pTask, uint64_t runCount, uint32_t permille);
+static void benchReport(double wallSeconds);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint64_t gTimeNs;                // Virtual time since the start of the simulation
+static uint32_t gRandomState = 1;       // State of the xorshift random generator
+
+static Scheduler gScheduler;            // Scheduler under test
+
+/**
+ * @brief Task set, similar to the application (1ms task added as the most
+ * critical one)
+ */
+static BenchTask gTasks[] =
+{
+    { "1ms",    1,    40,  20, 0,  0 },
+    { "10ms",   10,   200, 20, 1,  800 },
+    { "25ms",   25,   600, 30, 0,  0 },
+    { "50ms",   50,   500, 20, 0,  0 },
+    { "250ms",  250,  1000, 50, 10, 3000 },
+};
+
+static const CyclicFunction gTaskFunctions[] = { benchTask0, benchTask1, benchTask2, benchTask3, benchTask4 };
+
+#define BENCH_TASK_COUNT    ((int32_t)(sizeof(gTasks) / sizeof(gTasks[0])))
+
+static uint64_t gCycleCalls;            // Number of schedCycle() calls
+static uint64_t gDispatchCalls;         // Number of schedCycle() calls which executed at least one task
+static uint64_t gIdleNs;                // Host time of the calls without task
+static uint64_t gDispatchNs;            // Host time of the calls with task
+static uint64_t gDispatchCount;         // Number of task executions
+static uint64_t gTaskNs;                // Host time spent inside the synthetic tasks
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(int argc, char** argv)
+{
+    double hours = 1.0;
+    SchedulerPolicy policy = SCHED_POLICY_SKIP;
+    int spread = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:s:p:S")) != -1)
+    {
+        switch (option)
+        {
+            case 't':
+                hours = atof(optarg);
+                break;
+
+            case 's':
+                gRandomState = (uint32_t)strtoul(optarg, 0, 0) | 1;
+                break;
+
+            case 'p':
+                if (strcmp(optarg, "rephase") == 0)
+                    policy = SCHED_POLICY_REPHASE;
+                else if (strcmp(optarg, "catchup") == 0)
+                    policy = SCHED_POLICY_CATCH_UP;
+                else
+                    policy = SCHED_POLICY_SKIP;
+                break;
+
+            case 'S':
+                spread = 1;
+                break;
+
+            default:
+                fprintf(stderr, "Usage: %s [-t hours] [-s seed] [-p skip|rephase|catchup] [-S]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    gScheduler.pGetHALTick = benchGetHALTick;
+    gScheduler.pGetCycleCount = benchGetCycleCount;
+    schedInitialize(&gScheduler);
+
+    for (int32_t i = 0; i < BENCH_TASK_COUNT; i++)
+    {
+        gTasks[i].taskID = schedAddTask(&gScheduler, gTaskFunctions[i], gTasks[i].period, 0);
+        schedSetTaskPolicy(&gScheduler, gTasks[i].taskID, policy, 2);
+    }
+
+    uint64_t endNs = (uint64_t)(hours * 3600.0 * 1e9);
+    uint64_t spreadNs = spread ? BENCH_SPREAD_DELAY * BENCH_NS_PER_TICK : UINT64_MAX;
+    uint64_t wallStart = benchHostNs();
+
+    while (gTimeNs < endNs)
+    {
+        // Remember the release of each task, it is updated by schedCycle()
+        // before the task is executed
+        for (int32_t i = 0; i < BENCH_TASK_COUNT; i++)
+        {
+            gTasks[i].releaseTick = gScheduler.tasks[gTasks[i].taskID].nextRelease;
+        }
+
+        uint64_t dispatchCount = gDispatchCount;
+        uint64_t taskNs = gTaskNs;
+        uint64_t startNs = benchHostNs();
+
+        schedCycle(&gScheduler);
+
+        uint64_t cycleNs = benchHostNs() - startNs - (gTaskNs - taskNs);
+        gCycleCalls++;
+
+        if (gDispatchCount != dispatchCount)
+        {
+            gDispatchCalls++;
+            gDispatchNs += cycleNs;
+        }
+        else
+        {
+            gIdleNs += cycleNs;
+        }
+
+        if (gTimeNs >= spreadNs)
+        {
+            schedSpreadPhases(&gScheduler);
+            schedResetTaskStats(&gScheduler);
+            spreadNs = UINT64_MAX;
+
+            for (int32_t i = 0; i < BENCH_TASK_COUNT; i++)
+            {
+                gTasks[i].missedDeadlines = 0;
+                memset(gTasks[i].hist, 0, sizeof(gTasks[i].hist));
+            }
+        }
+
+        // Tickless idle: continue at the beginning of the tick of the next release
+        uint32_t nextRelease;
+        if (schedGetNextRelease(&gScheduler, &nextRelease) == SCHED_ERR_OK)
+        {
+            int32_t delta = (int32_t)(nextRelease - benchGetHALTick());
+            if (delta > 0)
+                gTimeNs = (gTimeNs / BENCH_NS_PER_TICK + (uint64_t)delta) * BENCH_NS_PER_TICK;
+        }
+    }
+
+    benchReport((benchHostNs() - wallStart) / 1e9);
+
+    return 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Virtual HAL tick
+ */
+static uint32_t benchGetHALTick(void)
+{
+    return (uint32_t)(BENCH_START_TICK + gTimeNs / BENCH_NS_PER_TICK);
+}
+
+/**
+ * @brief Virtual cycle counter
+ */
+static uint32_t benchGetCycleCount(void)
+{
+    return (uint32_t)(gTimeNs * BENCH_CPU_MHZ / 1000ULL);
+}
+
+/**
+ * @brief xorshift32 random generator, so each seed gives the same run
+ */
+static uint32_t benchRandom(void)
+{
+    gRandomState ^= gRandomState << 13;
+    gRandomState ^= gRandomState >> 17;
+    gRandomState ^= gRandomState << 5;
+
+    return gRandomState;
+}
+
+/**
+ * @brief Executes a synthetic task: records the jitter, advances the virtual
+ * clock by the task cost and checks the deadline
+ *
+ * @param index         Index of the task in gTasks
+ */
+static void benchRunTask(int32_t index)
+{
+    uint64_t hostStart = benchHostNs();
+    BenchTask* pTask = &gTasks[index];
+
+    // Jitter against the ideal release (start of the release tick)
+    uint64_t releaseNs = (uint64_t)(int32_t)(pTask->releaseTick - BENCH_START_TICK) * BENCH_NS_PER_TICK;
+    uint64_t jitterUs = (gTimeNs - releaseNs) / 1000;
+    uint32_t bucket = (uint32_t)(jitterUs / BENCH_HIST_BUCKET_US);
+
+    if (bucket >= BENCH_HIST_BUCKETS)
+        bucket = BENCH_HIST_BUCKETS - 1;
+
+    pTask->hist[bucket]++;
+
+    // Execution time with random variation and occasional spikes
+    uint64_t costNs = (uint64_t)pTask->costUs * 1000;
+    if (pTask->variationPercent > 0)
+    {
+        int64_t range = (int64_t)costNs * pTask->variationPercent / 100;
+        costNs += (int64_t)(benchRandom() % (uint32_t)(2 * range + 1)) - range;
+    }
+
+    if (pTask->spikePermille > 0 && (benchRandom() % 1000) < pTask->spikePermille)
+        costNs = (uint64_t)pTask->spikeUs * 1000;
+
+    gTimeNs += costNs;
+
+    // The deadline is the next regular release
+    uint64_t deadlineNs = releaseNs + (uint64_t)pTask->period * BENCH_NS_PER_TICK;
+    if (gTimeNs > deadlineNs)
+        pTask->missedDeadlines++;
+
+    // A task which catches up is executed again in the same schedCycle() call
+    pTask->releaseTick = gScheduler.tasks[pTask->taskID].nextRelease;
+
+    gDispatchCount++;
+    gTaskNs += benchHostNs() - hostStart;
+}
+
+static void benchTask0(void) { benchRunTask(0); }
+static void benchTask1(void) { benchRunTask(1); }
+static void benchTask2(void) { benchRunTask(2); }
+static void benchTask3(void) { benchRunTask(3); }
+static void benchTask4(void) { benchRunTask(4); }
+
+/**
+ * @brief Reads the monotonic host clock
+ */
+static uint64_t benchHostNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Returns the upper bound of the histogram bucket which contains the
+ * given percentile of the jitter
+ */
+static uint32_t benchPercentile(const BenchTask* pTask, uint64_t runCount, uint32_t permille)
+{
+    uint64_t limit = (runCount * permille + 999) / 1000;
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < BENCH_HIST_BUCKETS; i++)
+    {
+        sum += pTask->hist[i];
+        if (sum >= limit)
+            return (i + 1) * BENCH_HIST_BUCKET_US;
+    }
+
+    return BENCH_HIST_BUCKETS * BENCH_HIST_BUCKET_US;
+}
+
+/**
+ * @brief Prints the results of the simulation
+ */
+static void benchReport(double wallSeconds)
+{
+    double simSeconds = gTimeNs / 1e9;
+
+    printf("Simulated %.1f s in %.2f s wall time (x%.0f)\n", simSeconds, wallSeconds, simSeconds / wallSeconds);
+    printf("schedCycle: %llu calls, idle %.1f ns/call, dispatch %.1f ns/call (%llu tasks)\n",
+        (unsigned long long)gCycleCalls,
+        (gCycleCalls > gDispatchCalls) ? (double)gIdleNs / (gCycleCalls - gDispatchCalls) : 0.0,
+        (gDispatchCalls > 0) ? (double)gDispatchNs / gDispatchCalls : 0.0,
+        (unsigned long long)gDispatchCount);
+
+    printf("\n%-6s %10s %8s %8s %8s %8s %8s %8s %8s %8s\n",
+        "task", "runs", "dlmiss", "missed", "skipped", "overrun", "p50us", "p99us", "p999us", "maxus");
+
+    for (int32_t i = 0; i < BENCH_TASK_COUNT; i++)
+    {
+        SchedulerTaskStats stats;
+        schedGetTaskStats(&gScheduler, gTasks[i].taskID, &stats);
+
+        uint64_t runCount = 0;
+        uint32_t maxBucket = 0;
+        for (uint32_t b = 0; b < BENCH_HIST_BUCKETS; b++)
+        {
+            runCount += gTasks[i].hist[b];
+            if (gTasks[i].hist[b] > 0)
+                maxBucket = b;
+        }
+
+        printf("%-6s %10llu %8llu %8lu %8lu %8lu %8lu %8lu %8lu %8lu\n",
+            gTasks[i].pName, (unsigned long long)runCount, (unsigned long long)gTasks[i].missedDeadlines,
+            (unsigned long)stats.missedCount, (unsigned long)stats.skippedCount, (unsigned long)stats.overrunCount,
+            (unsigned long)benchPercentile(&gTasks[i], runCount, 500),
+            (unsigned long)benchPercentile(&gTasks[i], runCount, 990),
+            (unsigned long)benchPercentile(&gTasks[i], runCount, 999),
+            (unsigned long)((maxBucket + 1) * BENCH_HIST_BUCKET_US));
+    }
+}
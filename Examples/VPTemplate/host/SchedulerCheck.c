@@ -0,0 +1,174 @@
+/******************************************************************************
+ * @file SchedulerCheck.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host check of the missed release policies of the scheduler
+ *
+ * @details A single task is stalled for several periods and the next release,
+ * the number of executions and the missed and skipped releases are compared
+ * with the expected values of each policy. The virtual HAL tick starts a few
+ * ticks before its 32bit wrap around, the start tick is moved over the whole
+ * stall, so the wrap is covered at every position (before, inside and after
+ * the stall). A failing check aborts with an assertion.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#undef NDEBUG
+#include <assert.h>
+#include <stdio.h>
+
+#include "Scheduler.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define CHECK_PERIOD            7               //!< Period of the task in HAL ticks
+#define CHECK_STALL_PERIODS     10              //!< Number of periods the task is stalled
+#define CHECK_STALL_OFFSET      3               //!< Additional delay of the stall (less than a period)
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t checkGetHALTick(void);
+static void checkTask(void);
+static void checkPolicy(SchedulerPolicy policy, uint32_t maxCatchUp, uint32_t startTick);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gTick = 0;              // Virtual HAL tick
+static uint32_t gRunCount = 0;          // Number of executions of the task
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    uint32_t checks = 0;
+
+    for (uint32_t k = 0; k <= (CHECK_STALL_PERIODS + 2) * CHECK_PERIOD; k++)
+    {
+        uint32_t startTick = UINT32_MAX - k;
+
+        checkPolicy(SCHED_POLICY_SKIP, 0, startTick);
+        checkPolicy(SCHED_POLICY_REPHASE, 0, startTick);
+        checkPolicy(SCHED_POLICY_CATCH_UP, 1, startTick);
+        checkPolicy(SCHED_POLICY_CATCH_UP, CHECK_STALL_PERIODS - 3, startTick);
+        checkPolicy(SCHED_POLICY_CATCH_UP, CHECK_STALL_PERIODS, startTick);
+        checkPolicy(SCHED_POLICY_CATCH_UP, CHECK_STALL_PERIODS + 5, startTick);
+        checks += 6;
+    }
+
+    printf("scheduler: %u policy checks passed\n", checks);
+
+    return 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief HAL tick of the scheduler
+ */
+static uint32_t checkGetHALTick(void)
+{
+    return gTick;
+}
+
+/**
+ * @brief Task under test, only counts its executions
+ */
+static void checkTask(void)
+{
+    gRunCount++;
+}
+
+/**
+ * @brief Stalls the task and checks the result of the policy
+ *
+ * The task is released at startTick, runs once on time and its following
+ * release is then delayed by CHECK_STALL_PERIODS periods (plus an offset).
+ * All due executions are dispatched at the delayed tick, afterwards the task
+ * must run exactly once at the next release which has been calculated.
+ */
+static void checkPolicy(SchedulerPolicy policy, uint32_t maxCatchUp, uint32_t startTick)
+{
+    Scheduler sched = { .pGetHALTick = checkGetHALTick, .pGetCycleCount = 0 };
+    SchedulerTaskStats stats;
+    uint32_t nextRelease = 0;
+
+    gTick = startTick;
+    gRunCount = 0;
+
+    assert(schedInitialize(&sched) == SCHED_ERR_OK);
+
+    int32_t taskID = schedAddTask(&sched, checkTask, CHECK_PERIOD, 0);
+    assert(taskID >= 0);
+    assert(schedSetTaskPolicy(&sched, taskID, policy, maxCatchUp) == SCHED_ERR_OK);
+
+    // First release on time
+    assert(schedCycle(&sched) == SCHED_ERR_OK);
+    assert(gRunCount == 1);
+
+    uint32_t release = startTick + CHECK_PERIOD;
+    assert(schedGetNextRelease(&sched, &nextRelease) == SCHED_ERR_OK);
+    assert(nextRelease == release);
+
+    // Stall: the release is missed by CHECK_STALL_PERIODS periods
+    gTick = release + CHECK_STALL_PERIODS * CHECK_PERIOD + CHECK_STALL_OFFSET;
+    assert(schedCycle(&sched) == SCHED_ERR_OK);
+
+    // Expected executions, missed and skipped releases of the stall
+    uint32_t runs = 1;
+    uint32_t missed = 1;
+    uint32_t skipped = CHECK_STALL_PERIODS;
+    uint32_t expectedRelease = release + (CHECK_STALL_PERIODS + 1) * CHECK_PERIOD;
+
+    if (policy == SCHED_POLICY_REPHASE)
+    {
+        expectedRelease = gTick + CHECK_PERIOD;
+    }
+    else if (policy == SCHED_POLICY_CATCH_UP)
+    {
+        // Each catch-up execution except the last one starts late again
+        uint32_t catchUp = (maxCatchUp < CHECK_STALL_PERIODS) ? maxCatchUp : CHECK_STALL_PERIODS;
+
+        runs    = 1 + catchUp;
+        missed  = catchUp;
+        skipped = CHECK_STALL_PERIODS - catchUp;
+    }
+
+    assert(schedGetTaskStats(&sched, taskID, &stats) == SCHED_ERR_OK);
+    assert(gRunCount == 1 + runs);
+    assert(stats.runCount == 1 + runs);
+    assert(stats.missedCount == missed);
+    assert(stats.skippedCount == skipped);
+
+    assert(schedGetNextRelease(&sched, &nextRelease) == SCHED_ERR_OK);
+    assert(nextRelease == expectedRelease);
+
+    // Back on the time grid: nothing is due before the next release
+    gTick = expectedRelease - 1;
+    assert(schedCycle(&sched) == SCHED_ERR_OK);
+    assert(gRunCount == 1 + runs);
+
+    gTick = expectedRelease;
+    assert(schedCycle(&sched) == SCHED_ERR_OK);
+    assert(gRunCount == 2 + runs);
+
+    assert(schedGetNextRelease(&sched, &nextRelease) == SCHED_ERR_OK);
+    assert(nextRelease == expectedRelease + CHECK_PERIOD);
+}
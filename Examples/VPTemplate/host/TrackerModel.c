@@ -0,0 +1,186 @@
+/******************************************************************************
+ * @file TrackerModel.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Host reference model of the fixed-point alpha-beta tracker
+ *
+ * @details Runs the Q31 tracker of the Filter library and a double precision
+ * alpha-beta model (same initialization) on ramps, steps and a sine with
+ * noise in the range of a 16bit oversampled ADC. Reported are the maximum
+ * deviation of value and rate from the model, the mean and the RMS error
+ * against the noise free signal (after settling), both compared to an EMA
+ * with the same alpha.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Filter/Filter.h"
+#include "Filter/FilterDesign.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define MODEL_SAMPLES           20000           //!< Number of samples per signal
+#define MODEL_SETTLE_SAMPLES    2000            //!< Samples skipped for the lag and noise statistics
+#define MODEL_NOISE             40              //!< Peak noise (uniform) in LSB
+
+#define MODEL_SIGNAL_RAMP       0               //!< Slow ramp
+#define MODEL_SIGNAL_STEEP      1               //!< Steep ramp
+#define MODEL_SIGNAL_STEPS      2               //!< Steps every 1000 samples
+#define MODEL_SIGNAL_SINE       3               //!< Sine
+#define MODEL_SIGNAL_COUNT      4
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief Double precision alpha-beta tracker
+ */
+typedef struct _ModelTracker
+{
+    double alpha;                       //!< Gain of the value
+    double beta;                        //!< Gain of the rate
+    int32_t valueCount;                 //!< Number of values since the start (max. 2)
+    double estimate;                    //!< Estimated value
+    double rate;                        //!< Estimated change per sample
+} ModelTracker;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static double modelSignal(int32_t signal, int32_t n);
+static void modelTracker(ModelTracker* pModel, double measurement);
+static void modelRun(int32_t signal, double alpha);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static const char* gSignalNames[MODEL_SIGNAL_COUNT] = { "ramp 0.5", "ramp 4", "steps", "sine" };
+static const double gAlphas[] = { 0.05, 0.1, 0.2, 0.5 };
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int main(void)
+{
+    printf("%-9s %5s %9s %9s %9s %9s %9s %9s\n", "signal", "alpha", "maxErr", "maxRate",
+        "meanTrk", "meanEMA", "rmsTrk", "rmsEMA");
+
+    for (uint32_t a = 0; a < sizeof(gAlphas) / sizeof(gAlphas[0]); a++)
+    {
+        for (int32_t signal = 0; signal < MODEL_SIGNAL_COUNT; signal++)
+        {
+            modelRun(signal, gAlphas[a]);
+        }
+    }
+
+    return 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Noise free test signal in the range of a 16bit ADC
+ */
+static double modelSignal(int32_t signal, int32_t n)
+{
+    switch (signal)
+    {
+        case MODEL_SIGNAL_RAMP:
+            return 10000.0 + 0.5 * n;
+
+        case MODEL_SIGNAL_STEEP:
+            return 1000.0 + 3.0 * n;
+
+        case MODEL_SIGNAL_STEPS:
+            return ((n / 1000) & 1) ? 50000.0 : 10000.0;
+
+        default:
+            return 32768.0 + 20000.0 * sin(n * 0.002);
+    }
+}
+
+/**
+ * @brief Double precision alpha-beta tracker, initialized like filterTracker()
+ */
+static void modelTracker(ModelTracker* pModel, double measurement)
+{
+    if (pModel->valueCount < 2)
+    {
+        pModel->rate = (pModel->valueCount == 0) ? 0.0 : measurement - pModel->estimate;
+        pModel->estimate = measurement;
+        pModel->valueCount++;
+        return;
+    }
+
+    double predicted = pModel->estimate + pModel->rate;
+    double residual = measurement - predicted;
+
+    pModel->estimate = predicted + pModel->alpha * residual;
+    pModel->rate += pModel->beta * residual;
+}
+
+/**
+ * @brief Runs fixed-point tracker, model and EMA on one signal
+ */
+static void modelRun(int32_t signal, double alpha)
+{
+    double beta = alpha * alpha / (2.0 - alpha);
+    TrackerFilterData_t tracker;
+    ModelTracker model = { alpha, beta, 0, 0.0, 0.0 };
+    double ema = 0.0;
+
+    filterInitTracker(&tracker, FILTER_DESIGN_Q31(alpha), FILTER_DESIGN_Q31(beta));
+    srand(1);
+
+    double errorMax = 0.0;
+    double rateErrorMax = 0.0;
+    double lagTracker = 0.0;
+    double lagEMA = 0.0;
+    double noiseTracker = 0.0;
+    double noiseEMA = 0.0;
+
+    for (int32_t n = 0; n < MODEL_SAMPLES; n++)
+    {
+        double clean = modelSignal(signal, n);
+        int32_t sample = (int32_t)clean + (rand() % (2 * MODEL_NOISE + 1)) - MODEL_NOISE;
+
+        int32_t value = filterTracker(&tracker, sample);
+        modelTracker(&model, sample);
+        ema = (n == 0) ? sample : ema + alpha * (sample - ema);
+
+        double rate = (double)filterTrackerRate(&tracker) / (1 << FILTER_TRACKER_FRAC_BITS);
+
+        if (fabs(value - model.estimate) > errorMax)
+            errorMax = fabs(value - model.estimate);
+        if (fabs(rate - model.rate) > rateErrorMax)
+            rateErrorMax = fabs(rate - model.rate);
+
+        if (n >= MODEL_SETTLE_SAMPLES)
+        {
+            lagTracker += clean - value;
+            lagEMA += clean - ema;
+            noiseTracker += (value - clean) * (value - clean);
+            noiseEMA += (ema - clean) * (ema - clean);
+        }
+    }
+
+    double count = MODEL_SAMPLES - MODEL_SETTLE_SAMPLES;
+
+    printf("%-9s %5.2f %9.3f %9.5f %9.2f %9.2f %9.2f %9.2f\n", gSignalNames[signal], alpha, errorMax,
+        rateErrorMax, lagTracker / count, lagEMA / count, sqrt(noiseTracker / count), sqrt(noiseEMA / count));
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * @file AppSchedule.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Static frame table of the cyclic executive
+ *
+ * @details Generated by Scripts/gen_cyclic_schedule.py from AppSchedule.json,
+ * DO NOT EDIT. Hyperperiod 250 ticks, minor frame 10 ticks (10000 us).
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "AppSchedule.h"
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+void taskApp10ms(void);
+void taskDemo25ms(void);
+void taskApp50ms(void);
+void taskApp250ms(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+/**
+ * @brief Tasks of all frames in order of execution
+ */
+static const CyclicFunction gFrameTasks[] =
+{
+    // Frame 0 @ 0: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 1 @ 10: 700/10000 us
+    taskApp10ms,
+    taskApp50ms,
+    // Frame 2 @ 20: 1200/10000 us
+    taskApp10ms,
+    taskApp250ms,
+    // Frame 3 @ 30: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 4 @ 40: 200/10000 us
+    taskApp10ms,
+    // Frame 5 @ 50: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 6 @ 60: 700/10000 us
+    taskApp10ms,
+    taskApp50ms,
+    // Frame 7 @ 70: 200/10000 us
+    taskApp10ms,
+    // Frame 8 @ 80: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 9 @ 90: 200/10000 us
+    taskApp10ms,
+    // Frame 10 @ 100: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 11 @ 110: 700/10000 us
+    taskApp10ms,
+    taskApp50ms,
+    // Frame 12 @ 120: 200/10000 us
+    taskApp10ms,
+    // Frame 13 @ 130: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 14 @ 140: 200/10000 us
+    taskApp10ms,
+    // Frame 15 @ 150: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 16 @ 160: 700/10000 us
+    taskApp10ms,
+    taskApp50ms,
+    // Frame 17 @ 170: 200/10000 us
+    taskApp10ms,
+    // Frame 18 @ 180: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 19 @ 190: 200/10000 us
+    taskApp10ms,
+    // Frame 20 @ 200: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 21 @ 210: 700/10000 us
+    taskApp10ms,
+    taskApp50ms,
+    // Frame 22 @ 220: 200/10000 us
+    taskApp10ms,
+    // Frame 23 @ 230: 1700/10000 us
+    taskApp10ms,
+    taskDemo25ms,
+    // Frame 24 @ 240: 200/10000 us
+    taskApp10ms,
+};
+
+/**
+ * @brief Index of the first task of each frame in gFrameTasks
+ */
+static const uint16_t gFrameStart[] =
+{
+    0, 2, 4, 6, 8, 9, 11, 13, 14, 16,
+    17, 19, 21, 22, 24, 25, 27, 29, 30, 32,
+    33, 35, 37, 38, 40, 41,
+};
+
+
+/***** PUBLIC VARIABLES ******************************************************/
+const SchedulerFrameTable gAppFrameTable =
+{
+    .minorFrame     = 10,
+    .frameCount     = 25,
+    .pTasks         = gFrameTasks,
+    .pFrameStart    = gFrameStart,
+};
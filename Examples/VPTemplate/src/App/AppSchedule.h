@@ -0,0 +1,32 @@
+/******************************************************************************
+ * @file AppSchedule.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File for the static frame table of the cyclic executive
+ *
+ * @details Generated by Scripts/gen_cyclic_schedule.py, DO NOT EDIT.
+ *
+ *
+ *****************************************************************************/
+#ifndef _APPSCHEDULE_H_
+#define _APPSCHEDULE_H_
+
+
+/***** INCLUDES **************************************************************/
+#include "Scheduler.h"
+
+/***** CONSTANTS *************************************************************/
+extern const SchedulerFrameTable gAppFrameTable;
+
+
+/***** MACROS ****************************************************************/
+#define APPSCHEDULE_MINOR_FRAME    10
+#define APPSCHEDULE_HYPERPERIOD    250
+
+#endif
@@ -0,0 +1,503 @@
+/******************************************************************************
+ * @file FilterBenchmark.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the benchmark of all Filter library kernels
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+
+#include "Filter/Filter.h"
+#include "Filter/FilterDesign.h"
+#include "FilterBenchmark.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define BENCH_BANK_CHANNELS         5       //!< Number of channels of the filter bank (ADC scan sequence)
+#define BENCH_WINDOW_SIZE           16      //!< Window size of the moving average and min/max filters
+#define BENCH_MEDIAN_SIZE           5       //!< Window size of the median filter
+#define BENCH_FIR_TAPS              8       //!< Number of taps of the FIR filter
+#define BENCH_CIC_ORDER             3       //!< Number of stages of the CIC decimator
+#define BENCH_CIC_SHIFT             3       //!< Decimation ratio of the CIC decimator as power of two
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+/**
+ * @brief Filter kernel under test
+ */
+typedef struct _FilterBenchKernel
+{
+    const char* pName;                  //!< Name of the kernel
+    uint32_t (*pRun)(void);             //!< Filters the input signal, returns the number of output samples
+    bool isOutput16;                    //!< Output in the 16bit buffer (otherwise in the 32bit buffer)
+} FilterBenchKernel;
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void filterBenchSignal(void);
+static uint32_t filterBenchOverhead(FilterBenchCycles pGetCycles);
+static void filterBenchKernel(const FilterBenchKernel* pKernel, FilterBenchCycles pGetCycles, uint32_t overhead,
+                              FilterBenchResult* pResult);
+static uint32_t filterBenchChecksum(const FilterBenchKernel* pKernel, uint32_t samples);
+static uint32_t benchEMAShift(void);
+static uint32_t benchEMAReciprocal(void);
+static uint32_t benchEMABlock(void);
+static uint32_t benchEMADual(void);
+static uint32_t benchEMABank(void);
+static uint32_t benchCIC(void);
+static uint32_t benchMovingAverage(void);
+static uint32_t benchMinimum(void);
+static uint32_t benchMaximum(void);
+static uint32_t benchMedian(void);
+static uint32_t benchTracker(void);
+static uint32_t benchFIR(void);
+static uint32_t benchBiquad(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static int32_t gInput[FILTER_BENCH_SAMPLES];            // 12bit input signal
+static int32_t gOutput[FILTER_BENCH_SAMPLES];           // Output of the 32bit kernels
+static int16_t gInputQ15[FILTER_BENCH_SAMPLES];         // Input signal as Q15 around mid scale
+static int16_t gReferenceQ15[FILTER_BENCH_SAMPLES];     // Output of a Q15 kernel with the software backend
+static FilterQ15Backend gQ15Backend = 0;                // Backend of the Q15 kernels (0 for the software backend)
+
+// 16bit buffers, 32bit aligned for the dual filter
+static union
+{
+    uint32_t words[FILTER_BENCH_SAMPLES / 2];
+    int16_t q15[FILTER_BENCH_SAMPLES];
+    uint16_t dual[FILTER_BENCH_SAMPLES];
+} gInput16, gOutput16;
+
+static int32_t gWindowBuffer[BENCH_WINDOW_SIZE];                            // Buffer of the moving average
+static MinMaxFilterEntry_t gDequeBuffer[BENCH_WINDOW_SIZE];                 // Buffer of the min/max filters
+static int32_t gMedianBuffer[FILTER_MEDIAN_BUFFER_SIZE(BENCH_MEDIAN_SIZE)]; // Buffer of the median filter
+
+// Low pass FIR filter, gain 1
+static const int16_t gFIRCoefficients[BENCH_FIR_TAPS] = { 511, 2048, 4608, 9216, 9216, 4608, 2048, 511 };
+
+// Biquad low pass (fc = 0.05 * fs, Butterworth)
+static const int16_t gBiquadB[3] = FILTER_BIQUAD_LOWPASS_B(0.05, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+static const int16_t gBiquadA[2] = FILTER_BIQUAD_LOWPASS_A(0.05, 1.0, FILTER_BIQUAD_Q_BUTTERWORTH);
+
+static const FilterBenchKernel gKernels[] =
+{
+    { "ema shift",      benchEMAShift,          false },
+    { "ema recip",      benchEMAReciprocal,     false },
+    { "ema block",      benchEMABlock,          false },
+    { "ema dual",       benchEMADual,           true },
+    { "ema bank5",      benchEMABank,           false },
+    { "cic5 3/8",       benchCIC,               false },
+    { "mavg 16",        benchMovingAverage,     false },
+    { "min 16",         benchMinimum,           false },
+    { "max 16",         benchMaximum,           false },
+    { "median 5",       benchMedian,            false },
+    { "tracker 0.2",    benchTracker,           false },
+    { "fir q15 8",      benchFIR,               true },
+    { "biquad q15",     benchBiquad,            true },
+};
+
+// Kernels which are run again with the backend under test
+static const FilterBenchKernel gQ15Kernels[] =
+{
+    { "fir q15 8",      benchFIR,               true },
+    { "biquad q15",     benchBiquad,            true },
+};
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+uint32_t filterBenchRun(FilterBenchCycles pGetCycles, FilterBenchResult* pResults, uint32_t maxResults)
+{
+    uint32_t kernelCount = sizeof(gKernels) / sizeof(gKernels[0]);
+
+    if (pGetCycles == 0 || pResults == 0)
+        return 0;
+
+    if (kernelCount > maxResults)
+        kernelCount = maxResults;
+
+    filterBenchSignal();
+    gQ15Backend = 0;
+
+    uint32_t overhead = filterBenchOverhead(pGetCycles);
+
+    for (uint32_t k = 0; k < kernelCount; k++)
+    {
+        filterBenchKernel(&gKernels[k], pGetCycles, overhead, &pResults[k]);
+    }
+
+    return kernelCount;
+}
+
+uint32_t filterBenchRunQ15Backend(FilterBenchCycles pGetCycles, FilterQ15Backend pBackend, FilterBenchResult* pResults,
+                                  uint32_t maxResults)
+{
+    uint32_t kernelCount = sizeof(gQ15Kernels) / sizeof(gQ15Kernels[0]);
+
+    if (pGetCycles == 0 || pBackend == 0 || pResults == 0)
+        return 0;
+
+    if (kernelCount > maxResults)
+        kernelCount = maxResults;
+
+    filterBenchSignal();
+
+    uint32_t overhead = filterBenchOverhead(pGetCycles);
+
+    for (uint32_t k = 0; k < kernelCount; k++)
+    {
+        const FilterBenchKernel* pKernel = &gQ15Kernels[k];
+
+        // Reference output of the software backend
+        gQ15Backend = 0;
+        uint32_t samples = pKernel->pRun();
+
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            gReferenceQ15[i] = gOutput16.q15[i];
+        }
+
+        gQ15Backend = pBackend;
+        filterBenchKernel(pKernel, pGetCycles, overhead, &pResults[k]);
+
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            if (gOutput16.q15[i] != gReferenceQ15[i])
+                pResults[k].mismatchCount++;
+        }
+    }
+
+    gQ15Backend = 0;
+
+    return kernelCount;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Generates the input signal: triangle between 1000 and 3000 with
+ * +/- 128 digits noise and a spike on about every 64th sample
+ */
+static void filterBenchSignal(void)
+{
+    uint32_t seed = 12345;
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        uint32_t phase = i % 200;
+        int32_t value = 1000 + (int32_t)((phase < 100) ? phase : (200 - phase)) * 20;
+
+        // Linear congruential generator (Numerical Recipes)
+        seed = seed * 1664525UL + 1013904223UL;
+        value += (int32_t)(seed >> 24) - 128;
+
+        if ((seed & 0x003F0000UL) == 0)
+            value += 1000;
+
+        gInput[i] = value;
+        gInput16.dual[i] = (uint16_t)value;
+        gInputQ15[i] = (int16_t)((value - 2048) * 16);
+    }
+}
+
+/**
+ * @brief Cycles of reading the counter itself
+ */
+static uint32_t filterBenchOverhead(FilterBenchCycles pGetCycles)
+{
+    uint32_t overhead = UINT32_MAX;
+
+    for (uint32_t r = 0; r < FILTER_BENCH_REPEAT; r++)
+    {
+        uint32_t start = pGetCycles();
+        uint32_t cycles = pGetCycles() - start;
+
+        if (cycles < overhead)
+            overhead = cycles;
+    }
+
+    return overhead;
+}
+
+/**
+ * @brief Runs a kernel FILTER_BENCH_REPEAT times and stores the fastest run
+ * and the checksum of its output
+ */
+static void filterBenchKernel(const FilterBenchKernel* pKernel, FilterBenchCycles pGetCycles, uint32_t overhead,
+                              FilterBenchResult* pResult)
+{
+    uint32_t samples = 0;
+    uint32_t best = UINT32_MAX;
+
+    for (uint32_t r = 0; r < FILTER_BENCH_REPEAT; r++)
+    {
+        uint32_t start = pGetCycles();
+        samples = pKernel->pRun();
+        uint32_t cycles = pGetCycles() - start;
+
+        if (cycles < best)
+            best = cycles;
+    }
+
+    best = (best > overhead) ? (best - overhead) : 0;
+
+    pResult->pName              = pKernel->pName;
+    pResult->samples            = samples;
+    pResult->cycles             = best;
+    pResult->cyclesPerSample100 = (samples > 0) ? (uint32_t)(((uint64_t)best * 100) / samples) : 0;
+    pResult->checksum           = filterBenchChecksum(pKernel, samples);
+    pResult->mismatchCount      = 0;
+}
+
+/**
+ * @brief FNV-1a checksum over the output samples of a kernel
+ */
+static uint32_t filterBenchChecksum(const FilterBenchKernel* pKernel, uint32_t samples)
+{
+    uint32_t checksum = 2166136261UL;
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        uint32_t value = (pKernel->isOutput16 == true) ? gOutput16.dual[i] : (uint32_t)gOutput[i];
+
+        checksum = (checksum ^ value) * 16777619UL;
+    }
+
+    return checksum;
+}
+
+/**
+ * @brief EMA filter per sample, shift path (alpha = 1/16)
+ */
+static uint32_t benchEMAShift(void)
+{
+    EMAFilterData_t ema = { 0 };
+    filterInitEMA(&ema, 16, 1, true);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterEMA(&ema, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief EMA filter per sample, generic path (alpha = 3/100)
+ */
+static uint32_t benchEMAReciprocal(void)
+{
+    EMAFilterData_t ema = { 0 };
+    filterInitEMA(&ema, 100, 3, true);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterEMA(&ema, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief EMA filter on the whole buffer (alpha = 3/100)
+ */
+static uint32_t benchEMABlock(void)
+{
+    EMAFilterData_t ema = { 0 };
+    filterInitEMA(&ema, 100, 3, true);
+    filterEMABlock(&ema, gInput, gOutput, FILTER_BENCH_SAMPLES);
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Dual 16bit EMA filter on the buffer as two interleaved channels
+ */
+static uint32_t benchEMADual(void)
+{
+    EMADualFilterData_t ema;
+    filterInitEMADual(&ema, 100, 3);
+    filterEMADual(&ema, gInput16.dual, gOutput16.dual, 2, FILTER_BENCH_SAMPLES / 2);
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief EMA filter bank on the buffer as frames of five channels
+ */
+static uint32_t benchEMABank(void)
+{
+    EMAFilterBank_t bank;
+    filterInitEMABank(&bank, BENCH_BANK_CHANNELS);
+
+    for (uint32_t c = 0; c < BENCH_BANK_CHANNELS; c++)
+    {
+        filterSetEMABankAlpha(&bank, c, 100, 3 + c);
+    }
+
+    // One frame per call like in the ADC conversion complete interrupt
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i += BENCH_BANK_CHANNELS)
+    {
+        filterEMABank(&bank, &gInput[i], 1);
+
+        for (uint32_t c = 0; c < BENCH_BANK_CHANNELS; c++)
+        {
+            gOutput[i + c] = bank.output[c];
+        }
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief CIC decimator bank (order 3, ratio 8) on the buffer as frames of
+ * five channels, the last output frame is held for the following frames
+ */
+static uint32_t benchCIC(void)
+{
+    CICFilterBank_t bank;
+    filterInitCICBank(&bank, BENCH_BANK_CHANNELS, BENCH_CIC_ORDER, BENCH_CIC_SHIFT);
+
+    // One frame per call like in the ADC conversion complete interrupt
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i += BENCH_BANK_CHANNELS)
+    {
+        filterCICBank(&bank, &gInput[i], 1);
+
+        for (uint32_t c = 0; c < BENCH_BANK_CHANNELS; c++)
+        {
+            gOutput[i + c] = bank.output[c];
+        }
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Moving average over 16 samples
+ */
+static uint32_t benchMovingAverage(void)
+{
+    MovingAverageFilterData_t filter;
+    filterInitMovingAverage(&filter, gWindowBuffer, BENCH_WINDOW_SIZE);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterMovingAverage(&filter, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Sliding minimum over 16 samples
+ */
+static uint32_t benchMinimum(void)
+{
+    MinMaxFilterData_t filter;
+    filterInitMinMax(&filter, gDequeBuffer, BENCH_WINDOW_SIZE, FILTER_MINIMUM);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterMinMax(&filter, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Sliding maximum over 16 samples
+ */
+static uint32_t benchMaximum(void)
+{
+    MinMaxFilterData_t filter;
+    filterInitMinMax(&filter, gDequeBuffer, BENCH_WINDOW_SIZE, FILTER_MAXIMUM);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterMinMax(&filter, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Median over 5 samples
+ */
+static uint32_t benchMedian(void)
+{
+    MedianFilterData_t filter;
+    filterInitMedian(&filter, gMedianBuffer, BENCH_MEDIAN_SIZE);
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterMedian(&filter, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Alpha-beta tracker (alpha = 0.2, Benedict-Bordner beta)
+ */
+static uint32_t benchTracker(void)
+{
+    TrackerFilterData_t tracker;
+    filterInitTracker(&tracker, FILTER_TRACKER_ALPHA(0.2), FILTER_TRACKER_BETA(0.2));
+
+    for (uint32_t i = 0; i < FILTER_BENCH_SAMPLES; i++)
+    {
+        gOutput[i] = filterTracker(&tracker, gInput[i]);
+    }
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Q15 FIR low pass with 8 taps (software backend or the backend
+ * under test)
+ */
+static uint32_t benchFIR(void)
+{
+    static const FilterQ15Config_t config =
+    {
+        FILTER_Q15_FIR, gFIRCoefficients, 0, BENCH_FIR_TAPS, 0, 0
+    };
+    static FilterQ15Data_t filter;      // Own address per kernel (the FMAC backend caches the loaded filter)
+
+    filterInitQ15(&filter, &config, gQ15Backend);
+    filterQ15Block(&filter, gInputQ15, gOutput16.q15, FILTER_BENCH_SAMPLES);
+
+    return FILTER_BENCH_SAMPLES;
+}
+
+/**
+ * @brief Q15 biquad low pass (software backend or the backend under test)
+ */
+static uint32_t benchBiquad(void)
+{
+    static const FilterQ15Config_t config =
+    {
+        FILTER_Q15_IIR, gBiquadB, gBiquadA, 3, 2, FILTER_BIQUAD_GAIN
+    };
+    static FilterQ15Data_t filter;      // Own address per kernel (the FMAC backend caches the loaded filter)
+
+    filterInitQ15(&filter, &config, gQ15Backend);
+    filterQ15Block(&filter, gInputQ15, gOutput16.q15, FILTER_BENCH_SAMPLES);
+
+    return FILTER_BENCH_SAMPLES;
+}
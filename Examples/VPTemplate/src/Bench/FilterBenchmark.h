@@ -0,0 +1,97 @@
+/******************************************************************************
+ * @file FilterBenchmark.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file of the benchmark of all Filter library kernels
+ *
+ * @details Every kernel filters the same synthetic 12bit ADC like signal
+ * (triangle with pseudo random noise and single spikes, generated without
+ * any library function). The cycles are read with the counter function of
+ * the platform (DWT on the target, TSC on the host) and the minimum of
+ * FILTER_BENCH_REPEAT runs is reported. The checksum of the output must be
+ * the same on all platforms and build profiles.
+ *
+ * filterBenchRunQ15Backend() runs the Q15 kernels once more with another
+ * backend (the FMAC on the target) and compares every output sample with
+ * the software backend.
+ *
+ * The module has no hardware dependency and is used by the benchmark
+ * firmware (src/main_bench.c) and by the host build (host/Makefile).
+ *
+ *
+ *****************************************************************************/
+#ifndef _FILTER_BENCHMARK_H_
+#define _FILTER_BENCHMARK_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "Filter/Filter.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define FILTER_BENCH_SAMPLES        600     //!< Number of input samples of each kernel (multiple of 2 and 5)
+#define FILTER_BENCH_REPEAT         5       //!< Number of runs of each kernel, the fastest one is reported
+#define FILTER_BENCH_MAX_KERNELS    16      //!< Max. number of kernels (size of the result array)
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Function pointer to read a free running 32bit cycle counter
+ */
+typedef uint32_t (*FilterBenchCycles)(void);
+
+/**
+ * @brief Result of one filter kernel
+ */
+typedef struct _FilterBenchResult
+{
+    const char* pName;                  //!< Name of the kernel
+    uint32_t samples;                   //!< Number of filtered samples per run
+    uint32_t cycles;                    //!< Cycles of the fastest run
+    uint32_t cyclesPerSample100;        //!< Cycles per sample * 100
+    uint32_t checksum;                  //!< Checksum of the output samples
+    uint32_t mismatchCount;             //!< Output samples which differ from the software backend (filterBenchRunQ15Backend() only)
+} FilterBenchResult;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Runs all filter kernels
+ *
+ * @param pGetCycles    Function to read the cycle counter
+ * @param pResults      Array for the results
+ * @param maxResults    Number of entries of the result array
+ *
+ * @return Number of results written to pResults
+ */
+uint32_t filterBenchRun(FilterBenchCycles pGetCycles, FilterBenchResult* pResults, uint32_t maxResults);
+
+/**
+ * @brief Runs the Q15 kernels with another backend and compares their
+ * output with the software backend
+ *
+ * The backend may need interrupts (e.g. fmacFilterQ15() waits for its DMA
+ * interrupt), so they must stay enabled while the kernels run.
+ *
+ * @param pGetCycles    Function to read the cycle counter
+ * @param pBackend      Backend under test
+ * @param pResults      Array for the results
+ * @param maxResults    Number of entries of the result array
+ *
+ * @return Number of results written to pResults
+ */
+uint32_t filterBenchRunQ15Backend(FilterBenchCycles pGetCycles, FilterQ15Backend pBackend, FilterBenchResult* pResults,
+                                  uint32_t maxResults);
+
+
+#endif
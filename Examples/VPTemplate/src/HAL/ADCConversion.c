@@ -0,0 +1,69 @@
+/******************************************************************************
+ * @file ADCConversion.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the calibrated conversion of the ADC channels
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "ADCModule.h"
+#include "ADCConversion.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t adcCalculateConversion(const ADC_Calibration_t* pCalibration, uint32_t vrefRaw,
+                               ADC_Conversion_t* pConversion)
+{
+    if (pCalibration == 0 || pConversion == 0)
+        return ADC_ERR_INVALID_PTR;
+
+    if (vrefRaw == 0 || pCalibration->vrefIntCal == 0 || pCalibration->tsCal2 <= pCalibration->tsCal1)
+        return ADC_ERR_INVALID_PARAM;
+
+    uint32_t tempRange = (ADC_CAL_TEMP2 - ADC_CAL_TEMP1) * 1000;
+    uint32_t tsSpan = pCalibration->tsCal2 - pCalibration->tsCal1;
+
+    // µV per digit, with 3.0 V = 3e6 µV and the 12bit full scale of VREFINT_CAL
+    uint64_t microVolts = (uint64_t)ADC_CAL_VREF_MV * 1000 * pCalibration->vrefIntCal;
+    uint64_t digits = (uint64_t)vrefRaw << ADC_CAL_RESOLUTION;
+
+    pConversion->voltage.scale  = fixLinearScale(microVolts, digits);
+    pConversion->voltage.offset = 0;
+    pConversion->vbat.scale     = fixLinearScale(microVolts * ADC_VBAT_DIVIDER, digits);
+    pConversion->vbat.offset    = 0;
+
+    // m°C per digit, VREFINT and the sensor are calibrated at the same VREF+
+    pConversion->temperature.scale  = fixLinearScale((uint64_t)tempRange * pCalibration->vrefIntCal,
+                                                     (uint64_t)vrefRaw * tsSpan);
+    pConversion->temperature.offset = ADC_CAL_TEMP1 * 1000
+                                      - (int32_t)((tempRange * pCalibration->tsCal1 + tsSpan / 2) / tsSpan);
+
+    return ADC_ERR_OK;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
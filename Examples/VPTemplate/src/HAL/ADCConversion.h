@@ -0,0 +1,93 @@
+/******************************************************************************
+ * @file ADCConversion.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File of the calibrated conversion of the ADC channels
+ *
+ * @details Calculates the linear conversions (see FixLinear_t) of the ADC
+ * digits to µV and m°C from the factory calibration and a measurement of
+ * the VREFINT channel. The calculation does not access the hardware, so it
+ * is used by the ADC module and checked on the host (host/ADCConversionCheck.c).
+ *
+ *
+ *****************************************************************************/
+#ifndef _ADC_CONVERSION_H
+#define _ADC_CONVERSION_H
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "FixedPoint/FixedPoint.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define ADC_CAL_VREF_MV             3000            //!< VREF+ of the factory calibration in mV (VREFINT_CAL_VREF, TEMPSENSOR_CAL_VREFANALOG)
+#define ADC_CAL_TEMP1               30              //!< Temperature of TS_CAL1 in °C (TEMPSENSOR_CAL1_TEMP)
+#define ADC_CAL_TEMP2               110             //!< Temperature of TS_CAL2 in °C (TEMPSENSOR_CAL2_TEMP)
+#define ADC_CAL_RESOLUTION          12              //!< Resolution of the calibration values (bits)
+
+#define ADC_VBAT_DIVIDER            3               //!< Internal divider of the VBat channel (VBat / 3)
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Factory calibration values of the device (12bit digits at
+ * ADC_CAL_VREF_MV)
+ *
+ */
+typedef struct _ADC_Calibration_
+{
+    uint16_t vrefIntCal;                //!< VREFINT_CAL
+    uint16_t tsCal1;                    //!< TS_CAL1 (at ADC_CAL_TEMP1)
+    uint16_t tsCal2;                    //!< TS_CAL2 (at ADC_CAL_TEMP2)
+} ADC_Calibration_t;
+
+/**
+ * @brief Conversions of the channels for one supply voltage
+ *
+ */
+typedef struct _ADC_Conversion_
+{
+    FixLinear_t voltage;                //!< Digits to µV (pots and VREFINT)
+    FixLinear_t vbat;                   //!< Digits to µV incl. the VBat divider
+    FixLinear_t temperature;            //!< Digits to m°C
+} ADC_Conversion_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Calculates the conversions for a measured VREFINT
+ *
+ * With the factory calibration (12bit digits at VREF+ = 3.0 V):
+ *
+ *   VDDA = 3.0 V * VREFINT_CAL * 2^(resolution - 12) / vrefRaw
+ *   U    = VDDA * digits / 2^resolution = 3.0 V * VREFINT_CAL * digits / (vrefRaw * 2^12)
+ *   T    = 30 °C + (110 °C - 30 °C) * (digits * VREFINT_CAL / vrefRaw - TS_CAL1) / (TS_CAL2 - TS_CAL1)
+ *
+ * Both are linear in the digits, the measured VREFINT digits cancel the
+ * resolution out. The divisions are only done here, each conversion is a
+ * fixLinear().
+ *
+ * @param pCalibration  Factory calibration values
+ * @param vrefRaw       Digits of the VREFINT channel (any resolution, which
+ *                      is then also the one of the converted digits)
+ * @param pConversion   Calculated conversions
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PTR or
+ * ADC_ERR_INVALID_PARAM if the measurement or the calibration values are
+ * invalid (pConversion is then not changed)
+ */
+int32_t adcCalculateConversion(const ADC_Calibration_t* pCalibration, uint32_t vrefRaw,
+                               ADC_Conversion_t* pConversion);
+
+
+#endif
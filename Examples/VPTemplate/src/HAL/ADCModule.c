@@ -21,16 +21,16 @@
 #include "System.h"
 #include "HardwareConfig.h"
 #include "ADCModule.h"
+#include "ADCConversion.h"
+#include "TimerModule.h"
+#include "Filter/Filter.h"
 
 #include <string.h>
 
 /***** PRIVATE CONSTANTS *****************************************************/
-static const int32_t MICROVOLTS_PER_DIGIT = 805;    //!< 805 µV / digit
 
 
 /***** PRIVATE MACROS ********************************************************/
-#define ADC_CHANNEL_COUNT       5                   //!< Total number of used ADC channels
-
 #define IDX_ADC_INPUT0          0                   //!< Array index for ADC channel 0 (Pot 1) in global ADC value array
 #define IDX_ADC_INPUT1          1                   //!< Array index for ADC channel 1 (Pot 2) in global ADC value array
 #define IDX_ADC_TEMP            2                   //!< Array index for ADC channel 2 (internal Temp) in global ADC value array
@@ -38,29 +38,170 @@ static const int32_t MICROVOLTS_PER_DIGIT = 805;    //!< 805 µV / digit
 #define IDX_ADC_VREF            4                   //!< Array index for ADC channel 4 (internal reference voltage) in global ADC value array
 
 
+#define ADC_MAX_OVERSAMPLING_LOG2   8                   //!< Max. hardware oversampling ratio (256) as power of two
+#define ADC_CLOCK_DIVIDER       4                   //!< Division of HCLK for the ADC clock (ADC_CLOCK_SYNC_PCLK_DIV4)
+
+#define ADC_NOMINAL_VDDA_MV     3300                //!< Supply voltage assumed until adcUpdateCalibration() is called
+
+#define ADC_DMA_BLOCK_SIZE      (ADC_DMA_BLOCK_FRAMES * ADC_CHANNEL_COUNT)  //!< Values per half of the DMA ring
+#define ADC_DMA_RING_SIZE       (2 * ADC_DMA_BLOCK_SIZE)                    //!< Values of the DMA ring
+
+/**
+ * @brief Compiler barrier, which keeps the frame access and the index
+ * update of the frame buffer in order (see WorkQueue.c)
+ */
+#define ADC_BARRIER()           __asm volatile ("" ::: "memory")
+
+// The hardware independent conversion uses the calibration conditions of the device
+#if (ADC_CAL_VREF_MV != VREFINT_CAL_VREF) || (ADC_CAL_VREF_MV != TEMPSENSOR_CAL_VREFANALOG) \
+    || (ADC_CAL_TEMP1 != TEMPSENSOR_CAL1_TEMP) || (ADC_CAL_TEMP2 != TEMPSENSOR_CAL2_TEMP) \
+    || (ADC_CAL_RESOLUTION != ADC_NATIVE_RESOLUTION)
+#error "ADCConversion.h does not match the factory calibration of the device"
+#endif
+
+
 /***** PRIVATE TYPES *********************************************************/
 
+/**
+ * @brief Configuration of one rank of the regular conversion sequence
+ *
+ */
+typedef struct _ADC_Rank_
+{
+    uint32_t channel;                   //!< ADC channel (HAL)
+    uint32_t rank;                      //!< Rank in the sequence (HAL)
+    uint32_t samplingTime;              //!< Sampling time (HAL)
+    uint32_t conversionCycles;          //!< ADC clocks of sampling and conversion (sampling time + 12.5)
+} ADC_Rank_t;
+
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 
 static void adcInitializeDMA(void);
+static void adcStartDMA(void);
+static void adcProcessBlock(const uint16_t* pBlock, const uint32_t* pTimestamps, uint32_t pendingFlag);
+static int32_t adcChannelIndex(ADC_Channel_t adcChannel);
+static int32_t adcOversamplingLog2(uint16_t ratio);
+static bool adcSequenceFits(uint32_t sequenceCycles, uint32_t rateMilliHz);
+static int32_t adcUpdateConversion(uint32_t vrefRaw);
+static int32_t adcConvertValue(int32_t index, int32_t value);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
+
+// Oversampling ratios and shifts of the HAL, indexed by log2(ratio) - 1 and by the shift
+static const uint32_t gOversamplingRatios[ADC_MAX_OVERSAMPLING_LOG2] =
+{
+    ADC_OVERSAMPLING_RATIO_2, ADC_OVERSAMPLING_RATIO_4, ADC_OVERSAMPLING_RATIO_8, ADC_OVERSAMPLING_RATIO_16,
+    ADC_OVERSAMPLING_RATIO_32, ADC_OVERSAMPLING_RATIO_64, ADC_OVERSAMPLING_RATIO_128, ADC_OVERSAMPLING_RATIO_256
+};
+
+static const uint32_t gOversamplingShifts[ADC_MAX_OVERSAMPLING_LOG2 + 1] =
+{
+    ADC_RIGHTBITSHIFT_NONE, ADC_RIGHTBITSHIFT_1, ADC_RIGHTBITSHIFT_2, ADC_RIGHTBITSHIFT_3, ADC_RIGHTBITSHIFT_4,
+    ADC_RIGHTBITSHIFT_5, ADC_RIGHTBITSHIFT_6, ADC_RIGHTBITSHIFT_7, ADC_RIGHTBITSHIFT_8
+};
+
+// Regular sequence, in the order of the IDX_ADC_... indices. The internal channels
+// need min. 5 µs (temperature sensor) and 4 µs (VREFINT) sampling time, which is
+// 7.7 µs with 247.5 clocks at 32 MHz (92.5 clocks = 2.9 µs are only enough for the pots)
+static const ADC_Rank_t gRanks[ADC_CHANNEL_COUNT] =
+{
+    { ADC_CHANNEL_1,                ADC_REGULAR_RANK_1, ADC_SAMPLETIME_92CYCLES_5,  105 },
+    { ADC_CHANNEL_2,                ADC_REGULAR_RANK_2, ADC_SAMPLETIME_92CYCLES_5,  105 },
+    { ADC_CHANNEL_TEMPSENSOR_ADC1,  ADC_REGULAR_RANK_3, ADC_SAMPLETIME_247CYCLES_5, 260 },
+    { ADC_CHANNEL_VBAT,             ADC_REGULAR_RANK_4, ADC_SAMPLETIME_247CYCLES_5, 260 },
+    { ADC_CHANNEL_VREFINT,          ADC_REGULAR_RANK_5, ADC_SAMPLETIME_247CYCLES_5, 260 }
+};
+
 static ADC_HandleTypeDef gADCHandle;                //!< Global handle for ADC peripheral
 static DMA_HandleTypeDef gDMA_ADC_Handle;           //!< Global handle for DMA peripheral used for ADC data transfer
 
-static uint32_t gADCValues[ADC_CHANNEL_COUNT];      //!< Global array for ADC values used by the DMA transfer
+static uint16_t gADCValues[ADC_DMA_RING_SIZE];      //!< Ring of two DMA blocks written by the DMA transfer (halfwords)
+static uint32_t gADCTimestamps[2 * ADC_DMA_BLOCK_FRAMES];   //!< Trigger timestamps of the frames of the DMA ring
+static EMAFilterBank_t gADCFilterBank;              //!< Filters of all channels, updated after each conversion sequence
+static CICFilterBank_t gADCDecimator;               //!< CIC decimator of all channels (if enabled)
+static bool gDecimatorEnabled = false;              //!< Flag whether the conversion sequences pass the CIC decimator
+static int32_t gResolution = ADC_NATIVE_RESOLUTION; //!< Resolution of the ADC values in bits
+static uint32_t gSequenceCycles = 0;                //!< ADC clocks per conversion sequence incl. oversampling (0 until adcInitialize(), which checks the rate itself)
+
+static ADC_Calibration_t gCalibration;              //!< Factory calibration values (VREFINT_CAL, TS_CAL1, TS_CAL2)
+static FixLinear_t gConversion[ADC_CHANNEL_COUNT];  //!< Conversion of the channels to µV or m°C
+static int32_t gSupplyMicroVolts = 0;               //!< Supply voltage (VDDA) of the current conversion in µV
+
+static WorkQueue* volatile gpConversionQueue = 0;   //!< Work queue for the conversion complete work item
+static volatile WorkFunction gpConversionWork = 0;  //!< Work function posted after each conversion sequence
+
+static ADC_Frame_t* volatile gpFrameBuffer = 0;     //!< Buffer which passes the frames to the task context
+static uint32_t gFrameMask = 0;                     //!< Size of the frame buffer - 1
+static volatile uint32_t gFrameHead = 0;            //!< Index of the next frame to write (DMA interrupt)
+static volatile uint32_t gFrameTail = 0;            //!< Index of the next frame to read (task context)
+
+static volatile ADC_Statistics_t gStatistics;       //!< Statistics of the acquisition
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
-int32_t adcInitialize()
+int32_t adcInitialize(const ADC_Acquisition_t* pAcquisition)
 {
+    static const ADC_Acquisition_t defaultAcquisition = ADC_ACQUISITION_DEFAULT;
+
+    if (pAcquisition == 0)
+        pAcquisition = &defaultAcquisition;
+
+    // Check the acquisition mode before the hardware is touched
+    int32_t ratioLog2 = adcOversamplingLog2(pAcquisition->oversamplingRatio);
+    int32_t resolution = ADC_NATIVE_RESOLUTION + ratioLog2 - pAcquisition->oversamplingShift;
+
+    if (ratioLog2 < 0 || resolution < ADC_NATIVE_RESOLUTION || resolution > ADC_MAX_RESOLUTION)
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    // All conversions of the oversampler must complete before the next trigger
+    uint32_t sequenceCycles = 0;
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
+    {
+        sequenceCycles += gRanks[i].conversionCycles;
+    }
+
+    sequenceCycles <<= ratioLog2;
+
+    if (!adcSequenceFits(sequenceCycles, timerGetTriggerRate()))
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    // The CIC sums must stay within 31 bits (unsigned ADC values)
+    gDecimatorEnabled = (pAcquisition->cicOrder > 0);
+
+    if (gDecimatorEnabled
+        && (resolution + pAcquisition->cicOrder * pAcquisition->cicDecimationShift > 31
+            || filterInitCICBank(&gADCDecimator, ADC_CHANNEL_COUNT, pAcquisition->cicOrder,
+                                 pAcquisition->cicDecimationShift) != FILTER_ERR_OK))
+    {
+        return ADC_ERR_INVALID_PARAM;
+    }
+
+    gResolution = resolution;
+    gSequenceCycles = sequenceCycles;
+
+    // Factory calibration values, the conversion starts with the nominal supply voltage
+    gCalibration.vrefIntCal = *VREFINT_CAL_ADDR;
+    gCalibration.tsCal1     = *TEMPSENSOR_CAL1_ADDR;
+    gCalibration.tsCal2     = *TEMPSENSOR_CAL2_ADDR;
+
+    adcUpdateConversion(((gCalibration.vrefIntCal * VREFINT_CAL_VREF) << (resolution - ADC_NATIVE_RESOLUTION))
+                        / ADC_NOMINAL_VDDA_MV);
+
     /* Initialize DMA block for use with ADC */
     adcInitializeDMA();
 
-    memset(gADCValues, 0, ADC_CHANNEL_COUNT * sizeof(uint32_t));
+    memset(gADCValues, 0, sizeof(gADCValues));
+
+    // All channels are passed unfiltered until adcSetChannelFilter() is called
+    filterInitEMABank(&gADCFilterBank, ADC_CHANNEL_COUNT);
 
     /**
      * Common config
@@ -85,6 +226,17 @@ int32_t adcInitialize()
     gADCHandle.Init.Overrun 				= ADC_OVR_DATA_PRESERVED;
     gADCHandle.Init.OversamplingMode 		= DISABLE;
 
+    // All conversions of the oversampler are started by the same trigger,
+    // so only the complete sequence causes a DMA interrupt
+    if (ratioLog2 > 0)
+    {
+        gADCHandle.Init.OversamplingMode                    = ENABLE;
+        gADCHandle.Init.Oversampling.Ratio                  = gOversamplingRatios[ratioLog2 - 1];
+        gADCHandle.Init.Oversampling.RightBitShift          = gOversamplingShifts[pAcquisition->oversamplingShift];
+        gADCHandle.Init.Oversampling.TriggeredMode          = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+        gADCHandle.Init.Oversampling.OversamplingStopReset  = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+    }
+
     if (HAL_ADC_Init(&gADCHandle) != HAL_OK)
     {
     	Error_Handler();
@@ -98,61 +250,29 @@ int32_t adcInitialize()
 		Error_Handler();
 	}
 
-	/** Configure Regular Channel
+	/** Configure Regular Channels
 	*/
-	sConfig.Channel 		= ADC_CHANNEL_1;
-	sConfig.Rank 			= ADC_REGULAR_RANK_1;
-	sConfig.SamplingTime 	= ADC_SAMPLETIME_92CYCLES_5;
 	sConfig.SingleDiff 		= ADC_SINGLE_ENDED;
 	sConfig.OffsetNumber 	= ADC_OFFSET_NONE;
 	sConfig.Offset 			= 0;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
-	}
-
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_2;
-	sConfig.Rank 			= ADC_REGULAR_RANK_2;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
-	}
-
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_TEMPSENSOR_ADC1;
-	sConfig.Rank 			= ADC_REGULAR_RANK_3;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
-	}
-
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_VBAT;
-	sConfig.Rank 			= ADC_REGULAR_RANK_4;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
-	{
-		Error_Handler();
-	}
 
-	/** Configure Regular Channel
-	*/
-	sConfig.Channel 		= ADC_CHANNEL_VREFINT;
-	sConfig.Rank 			= ADC_REGULAR_RANK_5;
-	if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
+	for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
 	{
-		Error_Handler();
+		sConfig.Channel 		= gRanks[i].channel;
+		sConfig.Rank 			= gRanks[i].rank;
+		sConfig.SamplingTime 	= gRanks[i].samplingTime;
+		if (HAL_ADC_ConfigChannel(&gADCHandle, &sConfig) != HAL_OK)
+		{
+			Error_Handler();
+		}
 	}
 
 	/* Calibrate the ADC */
     HAL_ADCEx_Calibration_Start(&gADCHandle, ADC_SINGLE_ENDED);
 
-    // Start ADC in DMA mode
-    // This assumes, that DMA peripheral has been already configured
-    HAL_ADC_Start_DMA(&gADCHandle, gADCValues, ADC_CHANNEL_COUNT);
+    // Start ADC in DMA mode with the ring of two blocks (half and full transfer interrupt)
+    // This assumes, that DMA peripheral and timer have been already configured
+    adcStartDMA();
 
 	return ADC_ERR_OK;
 }
@@ -206,8 +326,8 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
 	gDMA_ADC_Handle.Init.Direction 				= DMA_PERIPH_TO_MEMORY;
 	gDMA_ADC_Handle.Init.PeriphInc 				= DMA_PINC_DISABLE;
 	gDMA_ADC_Handle.Init.MemInc 				= DMA_MINC_ENABLE;
-	gDMA_ADC_Handle.Init.PeriphDataAlignment 	= DMA_PDATAALIGN_WORD;
-	gDMA_ADC_Handle.Init.MemDataAlignment 		= DMA_MDATAALIGN_WORD;
+	gDMA_ADC_Handle.Init.PeriphDataAlignment 	= DMA_PDATAALIGN_HALFWORD;
+	gDMA_ADC_Handle.Init.MemDataAlignment 		= DMA_MDATAALIGN_HALFWORD;
 	gDMA_ADC_Handle.Init.Mode 					= DMA_CIRCULAR;
 	gDMA_ADC_Handle.Init.Priority 				= DMA_PRIORITY_LOW;
 
@@ -226,42 +346,196 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
 
 int32_t adcReadChannelRaw(ADC_Channel_t adcChannel)
 {
-    int32_t adcValue = 0;
+    int32_t index = adcChannelIndex(adcChannel);
 
-    switch(adcChannel)
+    if (index < 0)
+        return 0;
+
+    // Filtered once per conversion sequence in the DMA interrupt
+    return gADCFilterBank.output[index];
+}
+
+int32_t adcReadChannel(ADC_Channel_t adcChannel)
+{
+    int32_t index = adcChannelIndex(adcChannel);
+
+    if (index < 0)
+        return 0;
+
+    return adcConvertValue(index, gADCFilterBank.output[index]);
+}
+
+int32_t adcConvertFrame(const ADC_Frame_t* pFrame, int32_t* pValues)
+{
+    if (pFrame == 0 || pValues == 0)
+        return ADC_ERR_INVALID_PTR;
+
+    for (int32_t i = 0; i < ADC_CHANNEL_COUNT; i++)
     {
-        case ADC_INPUT0:
-            adcValue = gADCValues[IDX_ADC_INPUT0];
-            break;
+        pValues[i] = adcConvertValue(i, pFrame->value[i]);
+    }
 
-        case ADC_INPUT1:
-            adcValue = gADCValues[IDX_ADC_INPUT1];
-            break;
+    return ADC_ERR_OK;
+}
 
-        case ADC_TEMP:
-            adcValue = gADCValues[IDX_ADC_TEMP];
-            break;
+int32_t adcUpdateCalibration()
+{
+    int32_t vrefRaw = gADCFilterBank.output[IDX_ADC_VREF];
 
-        case ADC_VBAT:
-            adcValue = gADCValues[IDX_ADC_VBAT];
-            break;
+    if (vrefRaw <= 0)
+        return ADC_ERR_INVALID_PARAM;
 
-        case ADC_VREF:
-            adcValue = gADCValues[IDX_ADC_VREF];
-            break;
+    return adcUpdateConversion(vrefRaw);
+}
+
+int32_t adcGetSupplyVoltage()
+{
+    return gSupplyMicroVolts;
+}
+
+int32_t adcGetResolution()
+{
+    return gResolution;
+}
+
+int32_t adcSetSampleRate(uint32_t rateHz, uint32_t* pAchievedMilliHz)
+{
+    if (rateHz == 0 || rateHz > TIMER_MAX_RATE_HZ || !adcSequenceFits(gSequenceCycles, rateHz * 1000))
+        return ADC_ERR_INVALID_PARAM;
+
+    if (timerSetTriggerRate(rateHz, pAchievedMilliHz) != TIMER_ERR_OK)
+        return ADC_ERR_INVALID_PARAM;
+
+    return ADC_ERR_OK;
+}
+
+uint32_t adcGetSampleRate()
+{
+    return timerGetTriggerRate();
+}
+
+
+int32_t adcSetConversionWork(WorkQueue* pQueue, WorkFunction pFunction)
+{
+    if (pQueue != 0 && pFunction == 0)
+        return ADC_ERR_INVALID_PARAM;
+
+    // Disable the queue first, so the ISR never sees a queue without function
+    gpConversionQueue   = 0;
+    gpConversionWork    = pFunction;
+    gpConversionQueue   = pQueue;
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcSetChannelFilter(ADC_Channel_t adcChannel, int32_t scalingFactor, int32_t alpha)
+{
+    int32_t index = adcChannelIndex(adcChannel);
+
+    if (index < 0)
+        return ADC_ERR_INVALID_PARAM;
+
+    if (filterSetEMABankAlpha(&gADCFilterBank, index, scalingFactor, alpha) != FILTER_ERR_OK)
+        return ADC_ERR_INVALID_PARAM;
+
+    return ADC_ERR_OK;
+}
+
+int32_t adcSetFrameBuffer(ADC_Frame_t* pBuffer, uint32_t size)
+{
+    // Size must be a power of two
+    if (pBuffer != 0 && (size == 0 || (size & (size - 1)) != 0))
+        return ADC_ERR_INVALID_PARAM;
+
+    // Disable the buffer first, so the ISR never sees an inconsistent buffer
+    gpFrameBuffer   = 0;
+    gFrameMask      = size - 1;
+    gFrameHead      = 0;
+    gFrameTail      = 0;
+    gpFrameBuffer   = pBuffer;
+
+    return ADC_ERR_OK;
+}
+
+uint32_t adcReadFrames(ADC_Frame_t* pFrames, uint32_t maxFrames)
+{
+    ADC_Frame_t* pBuffer = gpFrameBuffer;
+    uint32_t tail = gFrameTail;
+    uint32_t count = 0;
+
+    if (pBuffer == 0 || pFrames == 0)
+        return 0;
+
+    while (count < maxFrames && tail != gFrameHead)
+    {
+        ADC_BARRIER();
+
+        pFrames[count] = pBuffer[tail & gFrameMask];
+
+        // Release the slot after it has been copied completely
+        ADC_BARRIER();
+        tail++;
+        gFrameTail = tail;
+
+        count++;
     }
 
-    return adcValue;
+    return count;
 }
 
-int32_t adcReadChannel(ADC_Channel_t adcChannel)
+int32_t adcGetStatistics(ADC_Statistics_t* pStatistics)
 {
-    int32_t adcRawValue = adcReadChannelRaw(adcChannel);
-    int32_t adcMicroVoltValue = adcRawValue * MICROVOLTS_PER_DIGIT;
+    if (pStatistics == 0)
+        return ADC_ERR_INVALID_PTR;
+
+    *pStatistics = gStatistics;
 
-    return adcMicroVoltValue;
+    return ADC_ERR_OK;
 }
 
+/**
+ * @brief Half transfer callback of the HAL (called from DMA interrupt),
+ * the first block of the DMA ring is complete
+ *
+ * @param hadc: ADC handle pointer
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    // An already pending transfer complete means, that the DMA writes the first block again
+    adcProcessBlock(&gADCValues[0], &gADCTimestamps[0], DMA_FLAG_TC1);
+}
+
+/**
+ * @brief Conversion complete callback of the HAL (called from DMA
+ * interrupt), the second block of the DMA ring is complete
+ *
+ * @param hadc: ADC handle pointer
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    adcProcessBlock(&gADCValues[ADC_DMA_BLOCK_SIZE], &gADCTimestamps[ADC_DMA_BLOCK_FRAMES], DMA_FLAG_HT1);
+}
+
+/**
+ * @brief Error callback of the HAL (called from ADC interrupt)
+ *
+ * After an overrun the ADC doesn't request DMA transfers anymore, so the
+ * conversions are restarted at the beginning of the DMA ring (the frames of
+ * the incomplete block are lost).
+ *
+ * @param hadc: ADC handle pointer
+ */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc)
+{
+    if ((HAL_ADC_GetError(hadc) & HAL_ADC_ERROR_OVR) != 0)
+    {
+        gStatistics.adcOverrunCount++;
+
+        HAL_ADC_Stop_DMA(hadc);
+        timerStopTriggerCapture();
+        adcStartDMA();
+    }
+}
 
 
 /***** PRIVATE FUNCTIONS *****************************************************/
@@ -282,6 +556,224 @@ static void adcInitializeDMA(void)
     HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
 }
 
+/**
+ * @brief Starts the DMA transfers of the ADC values and of the trigger
+ * timestamps at the beginning of their rings
+ *
+ * The triggers are held meanwhile, so entry n of both rings belongs to the
+ * same trigger.
+ */
+static void adcStartDMA(void)
+{
+    timerSetTriggerEnabled(false);
+
+    timerStartTriggerCapture(gADCTimestamps, 2 * ADC_DMA_BLOCK_FRAMES);
+    // The length is given in transfers (halfwords), the HAL only takes a word pointer
+    HAL_ADC_Start_DMA(&gADCHandle, (uint32_t*)gADCValues, ADC_DMA_RING_SIZE);
+
+    timerSetTriggerEnabled(true);
+}
+
+/**
+ * @brief Processes a complete block of the DMA ring
+ *
+ * Decimates (if enabled) and filters all channels frame by frame, passes
+ * the (output) frames to the frame buffer and posts the work item once per
+ * block, the further processing is done in task context
+ *
+ * @param pBlock        First value of the block
+ * @param pTimestamps   Trigger timestamps of the frames of the block
+ * @param pendingFlag   DMA flag of the other half of the ring, which is
+ *                      set if the DMA has already completed it (the
+ *                      interrupt is late, the block is being overwritten)
+ */
+static void adcProcessBlock(const uint16_t* pBlock, const uint32_t* pTimestamps, uint32_t pendingFlag)
+{
+    ADC_Frame_t* pBuffer = gpFrameBuffer;
+    uint32_t frameCount = gStatistics.frameCount;
+    int32_t samples[ADC_CHANNEL_COUNT];
+
+    for (uint32_t n = 0; n < ADC_DMA_BLOCK_FRAMES; n++)
+    {
+        const int32_t* pFrame = samples;
+
+        // The filter banks work on 32bit values (CIC integrators)
+        for (uint32_t c = 0; c < ADC_CHANNEL_COUNT; c++)
+        {
+            samples[c] = pBlock[n * ADC_CHANNEL_COUNT + c];
+        }
+
+        if (gDecimatorEnabled)
+        {
+            // Only every 2^cicDecimationShift sequence completes an output frame
+            if (filterCICBank(&gADCDecimator, pFrame, 1) <= 0)
+                continue;
+
+            pFrame = gADCDecimator.output;
+        }
+
+        frameCount++;
+
+        filterEMABank(&gADCFilterBank, pFrame, 1);
+
+        if (pBuffer != 0)
+        {
+            uint32_t head = gFrameHead;
+
+            if ((head - gFrameTail) > gFrameMask)
+            {
+                gStatistics.frameOverflowCount++;
+                continue;
+            }
+
+            ADC_Frame_t* pEntry = &pBuffer[head & gFrameMask];
+
+            // The CIC decimator is normalized to the gain 1, so all values fit into 16 bits
+            for (uint32_t c = 0; c < ADC_CHANNEL_COUNT; c++)
+            {
+                pEntry->value[c] = (uint16_t)pFrame[c];
+            }
+            pEntry->timestamp = pTimestamps[n];
+
+            // Publish the frame only after it has been written completely
+            ADC_BARRIER();
+            gFrameHead = head + 1;
+        }
+    }
+
+    if (__HAL_DMA_GET_FLAG(&gDMA_ADC_Handle, pendingFlag) != 0)
+    {
+        gStatistics.dmaOverrunCount++;
+    }
+
+    gStatistics.blockCount++;
+
+    if (frameCount != gStatistics.frameCount)
+    {
+        gStatistics.frameCount = frameCount;
+
+        if (gpConversionQueue != 0)
+        {
+            workqPost(gpConversionQueue, gpConversionWork, frameCount);
+        }
+    }
+}
+
+/**
+ * @brief Returns the index of an ADC channel in the global ADC value array
+ *
+ * @param adcChannel Channel
+ *
+ * @return Index of the channel or -1 for an unknown channel
+ */
+static int32_t adcChannelIndex(ADC_Channel_t adcChannel)
+{
+    int32_t index = -1;
+
+    switch(adcChannel)
+    {
+        case ADC_INPUT0:
+            index = IDX_ADC_INPUT0;
+            break;
+
+        case ADC_INPUT1:
+            index = IDX_ADC_INPUT1;
+            break;
+
+        case ADC_TEMP:
+            index = IDX_ADC_TEMP;
+            break;
+
+        case ADC_VBAT:
+            index = IDX_ADC_VBAT;
+            break;
+
+        case ADC_VREF:
+            index = IDX_ADC_VREF;
+            break;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Returns log2 of a hardware oversampling ratio
+ *
+ * @param ratio Oversampling ratio (1 = no oversampling)
+ *
+ * @return log2(ratio) or -1 if the ratio is no power of two up to 256
+ */
+static int32_t adcOversamplingLog2(uint16_t ratio)
+{
+    for (int32_t log2 = 0; log2 <= ADC_MAX_OVERSAMPLING_LOG2; log2++)
+    {
+        if (ratio == (1U << log2))
+            return log2;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Checks whether a conversion sequence completes within one period
+ * of the trigger (otherwise the ADC would ignore triggers, and the
+ * timestamps wouldn't match the frames anymore)
+ *
+ * @param sequenceCycles    ADC clocks per conversion sequence
+ * @param rateMilliHz       Rate of the trigger in mHz (0 = not known yet)
+ *
+ * @return true if the sequence fits
+ */
+static bool adcSequenceFits(uint32_t sequenceCycles, uint32_t rateMilliHz)
+{
+    uint64_t adcClockMilliHz = (uint64_t)(HAL_RCC_GetHCLKFreq() / ADC_CLOCK_DIVIDER) * 1000;
+
+    return (uint64_t)sequenceCycles * rateMilliHz < adcClockMilliHz;
+}
+
+/**
+ * @brief Calculates the conversion of all channels for a measured VREFINT
+ * (see adcCalculateConversion())
+ *
+ * @param vrefRaw   Digits of the VREFINT channel (with the resolution of
+ *                  adcGetResolution())
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * the measurement or the calibration values are invalid
+ */
+static int32_t adcUpdateConversion(uint32_t vrefRaw)
+{
+    ADC_Conversion_t conversion;
+    int32_t result = adcCalculateConversion(&gCalibration, vrefRaw, &conversion);
+
+    if (result != ADC_ERR_OK)
+        return result;
+
+    gConversion[IDX_ADC_INPUT0] = conversion.voltage;
+    gConversion[IDX_ADC_INPUT1] = conversion.voltage;
+    gConversion[IDX_ADC_TEMP]   = conversion.temperature;
+    gConversion[IDX_ADC_VBAT]   = conversion.vbat;
+    gConversion[IDX_ADC_VREF]   = conversion.voltage;
+
+    gSupplyMicroVolts = fixLinear(&conversion.voltage, 1 << gResolution);
+
+    return ADC_ERR_OK;
+}
+
+/**
+ * @brief Converts the digits of a channel to µV or m°C (multiplication
+ * and shift only)
+ *
+ * @param index     Index of the channel
+ * @param value     Digits (with the resolution of adcGetResolution())
+ *
+ * @return Value in µV or m°C
+ */
+static int32_t adcConvertValue(int32_t index, int32_t value)
+{
+    return fixLinear(&gConversion[index], value);
+}
+
 /**
   * @brief This function handles DMA1 channel1 global interrupt.
   */
@@ -10,6 +10,39 @@
  *
  * @brief Header File for the ADC Service Layer Module
  *
+ * @details The acquisition mode is selected with adcInitialize(). The
+ * hardware oversampler of the ADC converts each channel of the sequence
+ * several times after one TIM3 trigger and sums the results, so the higher
+ * resolution costs no CPU time and no extra interrupt. The optional CIC
+ * decimator runs in the existing DMA interrupt and reduces the output rate
+ * by 2^cicDecimationShift.
+ *
+ * The oversampler applies to all channels of the sequence. All values of
+ * adcReadChannelRaw() have the resolution of adcGetResolution().
+ *
+ * The DMA writes the conversion sequences into a ring of two blocks of
+ * ADC_DMA_BLOCK_FRAMES frames. The half and full transfer interrupts
+ * process the block which has just been completed, while the DMA fills the
+ * other one, so no frame is read while it is written. The DMA transfers
+ * halfwords, the results of max. ADC_MAX_RESOLUTION bits are stored as
+ * uint16_t up to the frames of the consumer. All (decimated)
+ * frames can be passed to the task context with a frame buffer (see
+ * adcSetFrameBuffer()), frames and blocks which are lost are counted in
+ * the statistics.
+ *
+ * Each frame carries the timestamp of the TIM3 trigger which started its
+ * conversion. The timestamps are latched by TIM2 in hardware and copied by
+ * a second DMA into a ring parallel to the one of the ADC values (see
+ * TimerModule.h), so the time between two frames is exact.
+ *
+ * The conversion to µV and m°C uses the factory calibration (VREFINT_CAL,
+ * TS_CAL1, TS_CAL2), which is read once by adcInitialize(). The scale
+ * factors are precalculated for the supply voltage measured with the
+ * VREFINT channel (see adcUpdateCalibration()), so each conversion is a
+ * multiplication and a shift (fixLinear() of the FixedPoint library). The
+ * calculation of the scale factors is hardware independent, see
+ * ADCConversion.h.
+ *
  *
  *****************************************************************************/
 #ifndef _ADC_MODULE_H
@@ -18,12 +51,28 @@
 /***** INCLUDES **************************************************************/
 #include <stdint.h>
 
+#include "WorkQueue.h"
+
 /***** CONSTANTS *************************************************************/
 
 
 /***** MACROS ****************************************************************/
 #define ADC_ERR_OK                  0               //!< No error occured
 #define ADC_ERR_INIT_FAILURE        -1              //!< Error during ADC initialization
+#define ADC_ERR_INVALID_PARAM       -2              //!< Invalid parameter value
+#define ADC_ERR_INVALID_PTR         -3              //!< Invalid pointer
+
+#define ADC_NATIVE_RESOLUTION       12              //!< Resolution of a single conversion (bits)
+#define ADC_MAX_RESOLUTION          16              //!< Max. resolution of the (oversampled) conversion data register (bits)
+
+#define ADC_CHANNEL_COUNT           5               //!< Total number of used ADC channels (frame size)
+#define ADC_DMA_BLOCK_FRAMES        4               //!< Frames per half of the DMA ring (processed per interrupt)
+
+/**
+ * @brief Acquisition mode with single conversions (no oversampling, no
+ * CIC decimator)
+ */
+#define ADC_ACQUISITION_DEFAULT     { 1, 0, 0, 0 }
 
 /***** TYPES *****************************************************************/
 
@@ -40,35 +89,229 @@ typedef enum _ADC_Channel_
     ADC_VREF                //!< ADC Channel 4 used for internal reference voltage
 } ADC_Channel_t;
 
+/**
+ * @brief Acquisition mode of the ADC
+ *
+ * The oversampler sums oversamplingRatio conversions and shifts the sum
+ * right by oversamplingShift, which results in
+ * 12 + log2(oversamplingRatio) - oversamplingShift bits (12 .. 16). E.g.
+ * ratio 256 and shift 4 give 16 bits, of which about 16 are effective for
+ * white noise of at least 1 LSB (4 bits for 256 = 4^4 conversions).
+ *
+ * All conversions of a sequence must complete within one TIM3 period:
+ * (2 * 105 + 3 * 260) * ratio ADC clocks at 32 MHz (the internal channels
+ * need the longer sampling time), i.e. 7.9 ms for ratio 256, which is
+ * checked by adcInitialize() and adcSetSampleRate().
+ *
+ */
+typedef struct _ADC_Acquisition_
+{
+    uint16_t oversamplingRatio;     //!< Hardware oversampling ratio (1 = off, 2 .. 256 as power of two)
+    uint8_t oversamplingShift;      //!< Right shift of the sum of the oversampler (0 .. 8)
+    uint8_t cicOrder;               //!< Number of stages of the CIC decimator (0 = off, max. FILTER_CIC_MAX_ORDER)
+    uint8_t cicDecimationShift;     //!< Decimation ratio of the CIC decimator as power of two
+} ADC_Acquisition_t;
+
+/**
+ * @brief One frame (sample of all channels, after the CIC decimator if
+ * enabled, not EMA filtered), indexed by ADC_Channel_t
+ *
+ * A decimated frame has the timestamp of the last conversion sequence of
+ * the CIC decimator.
+ *
+ */
+typedef struct _ADC_Frame_
+{
+    uint16_t value[ADC_CHANNEL_COUNT];  //!< Values in digits (with the resolution of adcGetResolution())
+    uint32_t timestamp;                 //!< Time of the trigger in ticks of TIMER_TIMESTAMP_HZ
+} ADC_Frame_t;
+
+/**
+ * @brief Statistics of the acquisition
+ *
+ */
+typedef struct _ADC_Statistics_
+{
+    uint32_t frameCount;            //!< Number of (decimated) frames
+    uint32_t blockCount;            //!< Number of processed DMA blocks
+    uint32_t frameOverflowCount;    //!< Number of frames dropped because the frame buffer was full
+    uint32_t dmaOverrunCount;       //!< Number of DMA blocks overwritten before they were processed
+    uint32_t adcOverrunCount;       //!< Number of ADC overruns (the DMA ring is restarted)
+} ADC_Statistics_t;
+
 
 /***** PROTOTYPES ************************************************************/
 
 /**
  * @brief Initialize the ADC peripheral block
  *
- * @return Returns ADC_ERR_OK if no error occured
+ * @param pAcquisition  Acquisition mode (0 for ADC_ACQUISITION_DEFAULT)
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * the acquisition mode is invalid (the ADC is not started then)
+ */
+int32_t adcInitialize(const ADC_Acquisition_t* pAcquisition);
+
+/**
+ * @brief Returns the resolution of the values of adcReadChannelRaw()
+ *
+ * @return Resolution in bits (ADC_NATIVE_RESOLUTION .. ADC_MAX_RESOLUTION)
+ */
+int32_t adcGetResolution();
+
+/**
+ * @brief Sets the rate of the conversion sequences (TIM3 trigger)
+ *
+ * The timer settings are calculated from the actual clock tree. The rate
+ * is rejected if a conversion sequence of the current acquisition mode
+ * doesn't complete within one period: (2 * 105 + 3 * 260) *
+ * oversamplingRatio ADC clocks at HCLK / 4, i.e. max. 32.3 kHz without
+ * oversampling at 128 MHz. The rate before the CIC decimator is set.
+ *
+ * The channel filters are not adapted: filter coefficients designed for
+ * TIMER_SAMPLE_RATE_HZ (e.g. the alphas passed to adcSetChannelFilter())
+ * must be recomputed by the caller for the achieved rate.
+ *
+ * @param rateHz            Requested rate (1 Hz .. TIMER_MAX_RATE_HZ)
+ * @param pAchievedMilliHz  Achieved rate in mHz (may be 0)
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * the rate is out of range or the conversion sequence doesn't fit
+ */
+int32_t adcSetSampleRate(uint32_t rateHz, uint32_t* pAchievedMilliHz);
+
+/**
+ * @brief Returns the achieved rate of the conversion sequences
+ *
+ * @return Rate in mHz
  */
-int32_t adcInitialize();
+uint32_t adcGetSampleRate();
 
 /**
  * @brief Reads an ADC channel by returning the global ADC value read via
- * interrupt and DMA and converts it to millivolt
+ * interrupt and DMA (filtered, see adcSetChannelFilter()) and converts it
+ * with the calibration
  *
  * @param adcChannel Channel to read
  *
- * @return Returns value of ADC channel in microvolt [µV]
+ * @return Returns value of ADC channel in microvolt [µV] (ADC_VBAT: battery
+ * voltage before the internal divider), ADC_TEMP in milli degree Celsius [m°C]
  */
 int32_t adcReadChannel(ADC_Channel_t adcChannel);
 
+/**
+ * @brief Converts all channels of a frame with the calibration like
+ * adcReadChannel()
+ *
+ * @param pFrame        Frame (e.g. from adcReadFrames())
+ * @param pValues       Destination of the ADC_CHANNEL_COUNT values in µV or
+ *                      m°C, indexed by ADC_Channel_t
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PTR for
+ * a null pointer
+ */
+int32_t adcConvertFrame(const ADC_Frame_t* pFrame, int32_t* pValues);
+
+/**
+ * @brief Recalculates the conversion for the supply voltage, which is
+ * measured with the last (filtered) value of the VREFINT channel
+ *
+ * Until it is called the nominal supply voltage of 3.3 V is assumed. The
+ * divisions are done here (task context), call it e.g. cyclically from the
+ * task which reads the values.
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * no valid VREFINT value is available yet (the conversion is unchanged)
+ */
+int32_t adcUpdateCalibration();
+
+/**
+ * @brief Returns the supply voltage (VDDA) used by the conversion
+ *
+ * @return Supply voltage in µV
+ */
+int32_t adcGetSupplyVoltage();
+
 /**
  * @brief Reads an ADC channel by returning the global ADC value read via
- * interrupt and DMA
+ * interrupt and DMA (filtered, see adcSetChannelFilter())
  *
  * @param adcChannel Channel to read
  *
- * @return Returns value of ADC channel in digits
+ * @return Returns value of ADC channel in digits (with the resolution of
+ * adcGetResolution())
  */
 int32_t adcReadChannelRaw(ADC_Channel_t adcChannel);
 
+/**
+ * @brief Sets the EMA filter of an ADC channel
+ *
+ * All channels are filtered together after each conversion sequence in
+ * the DMA interrupt, so reading a channel doesn't cost any filtering.
+ * Channels without filter (default) return the last converted value.
+ *
+ * @param adcChannel    Channel to filter
+ * @param scalingFactor Scaling factor of alpha
+ * @param alpha         Already scaled alpha factor (alpha = scalingFactor disables the filter)
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * the channel is unknown or not 0 < alpha <= scalingFactor
+ */
+int32_t adcSetChannelFilter(ADC_Channel_t adcChannel, int32_t scalingFactor, int32_t alpha);
+
+/**
+ * @brief Sets the work item which is posted after each DMA block which
+ * completed at least one (output) frame
+ *
+ * The work function is executed later in task context (e.g. by the scheduler),
+ * the payload is the running number of the last (output) frame. The queue must
+ * only be used by interrupts with the same priority as the ADC/DMA interrupts.
+ *
+ * @param pQueue        Work queue to post to (0 to disable)
+ * @param pFunction     Work function to execute
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * a queue without function is provided
+ */
+int32_t adcSetConversionWork(WorkQueue* pQueue, WorkFunction pFunction);
+
+
+/**
+ * @brief Sets the buffer which passes all (decimated) frames to the task
+ * context
+ *
+ * The frames are written by the DMA interrupt and read with
+ * adcReadFrames(). If the buffer is full, new frames are dropped and
+ * counted in ADC_Statistics_t::frameOverflowCount.
+ *
+ * @param pBuffer       Buffer for the frames (0 to disable)
+ * @param size          Number of frames in the buffer (must be a power of two)
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PARAM if
+ * the size is no power of two
+ */
+int32_t adcSetFrameBuffer(ADC_Frame_t* pBuffer, uint32_t size);
+
+/**
+ * @brief Reads the frames from the frame buffer (oldest first, task
+ * context, single reader)
+ *
+ * @param pFrames       Destination of the frames
+ * @param maxFrames     Max. number of frames to read
+ *
+ * @return Number of frames read (0 if no frame buffer is set)
+ */
+uint32_t adcReadFrames(ADC_Frame_t* pFrames, uint32_t maxFrames);
+
+/**
+ * @brief Returns the statistics of the acquisition
+ *
+ * @param pStatistics   Destination of the statistics
+ *
+ * @return Returns ADC_ERR_OK if no error occured, ADC_ERR_INVALID_PTR for
+ * a null pointer
+ */
+int32_t adcGetStatistics(ADC_Statistics_t* pStatistics);
+
 
 #endif
@@ -0,0 +1,386 @@
+/******************************************************************************
+ * @file FMACModule.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the FMAC module, this includes the
+ * initialization of the FMAC and of the DMA channels for the input and
+ * output samples
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "stm32g4xx_hal.h"
+
+#include "System.h"
+#include "FMACModule.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define FMAC_BUFFER_SPARE           8               //!< Additional space of the input and output buffer in the FMAC memory
+#define FMAC_TIMEOUT_MS             100             //!< Timeout of a block in fmacFilterQ15() [ms]
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t fmacLoadFilter(FilterQ15Data_t* pFilter);
+static int32_t fmacToFilterError(int32_t result);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static FMAC_HandleTypeDef gFMACHandle;              //!< Global handle for FMAC peripheral
+static DMA_HandleTypeDef gDMA_FMACIn_Handle;        //!< Global handle for DMA channel writing the input samples
+static DMA_HandleTypeDef gDMA_FMACOut_Handle;       //!< Global handle for DMA channel reading the output samples
+
+static FilterQ15Data_t* gpActiveFilter = 0;         //!< Filter which is loaded into the FMAC
+static volatile bool gBlockBusy = false;            //!< Flag whether a block is processed
+static volatile bool gBlockError = false;           //!< Flag whether the last block had an error
+static int16_t* gpBlockOutput = 0;                  //!< Output buffer of the current block
+static uint32_t gBlockCount = 0;                    //!< Number of samples of the current block
+static FMACBlockCallback gpBlockCallback = 0;       //!< Callback of the current block
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t fmacInitialize()
+{
+    gFMACHandle.Instance = FMAC;
+
+    if (HAL_FMAC_Init(&gFMACHandle) != HAL_OK)
+    {
+        return FMAC_ERR_INIT_FAILURE;
+    }
+
+    gpActiveFilter = 0;
+    gBlockBusy = false;
+
+    return FMAC_ERR_OK;
+}
+
+/**
+* @brief FMAC MSP Initialization
+*
+* This function configures the clock of the FMAC and the DMA channels for
+* the input and output samples
+*
+* @param hfmac: FMAC handle pointer
+*
+* @remark: this HAL_FMAC_MspInit function is called automatically by the
+* STM32 HAL library
+*/
+void HAL_FMAC_MspInit(FMAC_HandleTypeDef* hfmac)
+{
+    if (hfmac->Instance == FMAC)
+    {
+        /* FMAC and DMA controller clock enable */
+        __HAL_RCC_FMAC_CLK_ENABLE();
+        __HAL_RCC_DMAMUX1_CLK_ENABLE();
+        __HAL_RCC_DMA1_CLK_ENABLE();
+
+        /* FMAC input DMA Init */
+        gDMA_FMACIn_Handle.Instance                 = DMA1_Channel2;
+        gDMA_FMACIn_Handle.Init.Request             = DMA_REQUEST_FMAC_WRITE;
+        gDMA_FMACIn_Handle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+        gDMA_FMACIn_Handle.Init.PeriphInc           = DMA_PINC_DISABLE;
+        gDMA_FMACIn_Handle.Init.MemInc              = DMA_MINC_ENABLE;
+        gDMA_FMACIn_Handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        gDMA_FMACIn_Handle.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+        gDMA_FMACIn_Handle.Init.Mode                = DMA_NORMAL;
+        gDMA_FMACIn_Handle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+        if (HAL_DMA_Init(&gDMA_FMACIn_Handle) != HAL_OK)
+        {
+            Error_Handler();
+        }
+
+        __HAL_LINKDMA(hfmac, hdmaIn, gDMA_FMACIn_Handle);
+
+        /* FMAC output DMA Init */
+        gDMA_FMACOut_Handle.Instance                 = DMA1_Channel3;
+        gDMA_FMACOut_Handle.Init.Request             = DMA_REQUEST_FMAC_READ;
+        gDMA_FMACOut_Handle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+        gDMA_FMACOut_Handle.Init.PeriphInc           = DMA_PINC_DISABLE;
+        gDMA_FMACOut_Handle.Init.MemInc              = DMA_MINC_ENABLE;
+        gDMA_FMACOut_Handle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+        gDMA_FMACOut_Handle.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+        gDMA_FMACOut_Handle.Init.Mode                = DMA_NORMAL;
+        gDMA_FMACOut_Handle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+        if (HAL_DMA_Init(&gDMA_FMACOut_Handle) != HAL_OK)
+        {
+            Error_Handler();
+        }
+
+        __HAL_LINKDMA(hfmac, hdmaOut, gDMA_FMACOut_Handle);
+
+        /* Same priority as the ADC/DMA interrupts, so a block can be started from there */
+        HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 0, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+        HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+        HAL_NVIC_SetPriority(FMAC_IRQn, 0, 0);
+        HAL_NVIC_EnableIRQ(FMAC_IRQn);
+    }
+}
+
+int32_t fmacStartFilterQ15(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count,
+                           FMACBlockCallback pCallback)
+{
+    if (pFilter == 0 || pInput == 0 || pOutput == 0 || count > FMAC_MAX_BLOCK_SIZE)
+        return FMAC_ERR_INVALID_PARAM;
+
+    if (gBlockBusy == true)
+        return FMAC_ERR_BUSY;
+
+    // Reload after a change of the filter and after filterInitQ15() or
+    // filterResetQ15() of the loaded one
+    if (pFilter != gpActiveFilter || pFilter->unloaded == true)
+    {
+        int32_t result = fmacLoadFilter(pFilter);
+
+        if (result != FMAC_ERR_OK)
+            return result;
+    }
+
+    if (count == 0)
+    {
+        if (pCallback != 0)
+            pCallback(pFilter, pOutput, 0);
+
+        return FMAC_ERR_OK;
+    }
+
+    // The input may be overwritten by the output, keep its end for a later reload
+    filterQ15SetHistory(pFilter, pInput, 0, count);
+
+    gpBlockOutput   = pOutput;
+    gBlockCount     = count;
+    gpBlockCallback = pCallback;
+    gBlockError     = false;
+    gBlockBusy      = true;
+
+    // The output DMA is started first, so it is ready for the first result
+    uint16_t outputSize = (uint16_t)count;
+    uint16_t inputSize = (uint16_t)count;
+
+    if (HAL_FMAC_ConfigFilterOutputBuffer(&gFMACHandle, pOutput, &outputSize) != HAL_OK
+        || HAL_FMAC_AppendFilterData(&gFMACHandle, (int16_t*)pInput, &inputSize) != HAL_OK)
+    {
+        gBlockBusy = false;
+        fmacStopFilter();
+        return FMAC_ERR_TRANSFER;
+    }
+
+    return FMAC_ERR_OK;
+}
+
+int32_t fmacFilterQ15(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count)
+{
+    if (pFilter == 0 || pInput == 0 || pOutput == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    int32_t result = fmacStartFilterQ15(pFilter, pInput, pOutput, count, 0);
+
+    if (result != FMAC_ERR_OK)
+        return fmacToFilterError(result);
+
+    uint32_t startTick = HAL_GetTick();
+
+    while (gBlockBusy == true)
+    {
+        if (HAL_GetTick() - startTick > FMAC_TIMEOUT_MS)
+        {
+            fmacStopFilter();
+            return fmacToFilterError(FMAC_ERR_TIMEOUT);
+        }
+    }
+
+    return (gBlockError == true) ? fmacToFilterError(FMAC_ERR_TRANSFER) : FILTER_ERR_OK;
+}
+
+bool fmacIsBusy()
+{
+    return gBlockBusy;
+}
+
+int32_t fmacStopFilter()
+{
+    HAL_DMA_Abort(&gDMA_FMACIn_Handle);
+    HAL_DMA_Abort(&gDMA_FMACOut_Handle);
+
+    gpActiveFilter = 0;
+    gBlockBusy = false;
+
+    if (HAL_FMAC_FilterStop(&gFMACHandle) != HAL_OK)
+    {
+        return FMAC_ERR_CONFIG;
+    }
+
+    return FMAC_ERR_OK;
+}
+
+/**
+ * @brief Output data ready callback of the HAL (called from DMA interrupt)
+ *
+ * @param hfmac: FMAC handle pointer
+ */
+void HAL_FMAC_OutputDataReadyCallback(FMAC_HandleTypeDef* hfmac)
+{
+    FilterQ15Data_t* pFilter = gpActiveFilter;
+
+    filterQ15SetHistory(pFilter, 0, gpBlockOutput, gBlockCount);
+    gBlockBusy = false;
+
+    if (gpBlockCallback != 0)
+    {
+        gpBlockCallback(pFilter, gpBlockOutput, gBlockCount);
+    }
+}
+
+/**
+ * @brief Error callback of the HAL (DMA error, under- or overflow of the
+ * FMAC buffers)
+ *
+ * @param hfmac: FMAC handle pointer
+ */
+void HAL_FMAC_ErrorCallback(FMAC_HandleTypeDef* hfmac)
+{
+    gBlockError = true;
+    gBlockBusy = false;
+
+    // The FMAC state is unknown, the filter is loaded again with the next block
+    gpActiveFilter = 0;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Configures the FMAC for the filter and preloads its state
+ *
+ * The FMAC memory is split into the input buffer, the coefficients and the
+ * output buffer. The previous input and output samples of the filter are
+ * preloaded, so the filter continues where its last block ended. The
+ * number of coefficients has been checked by filterInitQ15().
+ *
+ * @param pFilter       Filter to load
+ *
+ * @return Returns FMAC_ERR_OK if no error occured
+ */
+static int32_t fmacLoadFilter(FilterQ15Data_t* pFilter)
+{
+    FMAC_FilterConfigTypeDef config = {0};
+    const FilterQ15Config_t* pConfig = &pFilter->config;
+
+    fmacStopFilter();
+
+    config.InputBaseAddress     = 0;
+    config.InputBufferSize      = pConfig->countB + FMAC_BUFFER_SPARE;
+    config.InputThreshold       = FMAC_THRESHOLD_1;
+    config.CoeffBaseAddress     = config.InputBufferSize;
+    config.CoeffBufferSize      = pConfig->countB + pConfig->countA;
+    config.OutputBaseAddress    = config.CoeffBaseAddress + config.CoeffBufferSize;
+    config.OutputBufferSize     = pConfig->countA + FMAC_BUFFER_SPARE;
+    config.OutputThreshold      = FMAC_THRESHOLD_1;
+    config.pCoeffB              = (int16_t*)pConfig->pCoeffB;
+    config.CoeffBSize           = pConfig->countB;
+    config.InputAccess          = FMAC_BUFFER_ACCESS_DMA;
+    config.OutputAccess         = FMAC_BUFFER_ACCESS_DMA;
+    config.Clip                 = FMAC_CLIP_ENABLED;
+    config.P                    = pConfig->countB;
+    config.R                    = pConfig->gain;
+
+    if (pConfig->type == FILTER_Q15_IIR)
+    {
+        config.pCoeffA          = (int16_t*)pConfig->pCoeffA;
+        config.CoeffASize       = pConfig->countA;
+        config.Filter           = FMAC_FUNC_IIR_DIRECT_FORM_1;
+        config.Q                = pConfig->countA;
+    }
+    else
+    {
+        config.Filter           = FMAC_FUNC_CONVO_FIR;
+    }
+
+    if (HAL_FMAC_FilterConfig(&gFMACHandle, &config) != HAL_OK)
+    {
+        return FMAC_ERR_CONFIG;
+    }
+
+    int16_t* pOutputHistory = (pConfig->type == FILTER_Q15_IIR) ? pFilter->historyY : 0;
+
+    if (HAL_FMAC_FilterPreload(&gFMACHandle, pFilter->historyX, pConfig->countB - 1,
+                               pOutputHistory, pConfig->countA) != HAL_OK)
+    {
+        return FMAC_ERR_CONFIG;
+    }
+
+    // The output buffer is provided per block
+    if (HAL_FMAC_FilterStart(&gFMACHandle, 0, 0) != HAL_OK)
+    {
+        return FMAC_ERR_CONFIG;
+    }
+
+    gpActiveFilter = pFilter;
+    pFilter->unloaded = false;
+
+    return FMAC_ERR_OK;
+}
+
+/**
+ * @brief Maps an FMAC error to the error codes of the Filter library, which
+ * are returned by a FilterQ15Backend
+ *
+ * @param result        FMAC_ERR_* code
+ *
+ * @return FILTER_ERR_* code
+ */
+static int32_t fmacToFilterError(int32_t result)
+{
+    switch (result)
+    {
+        case FMAC_ERR_OK:
+            return FILTER_ERR_OK;
+
+        case FMAC_ERR_INVALID_PARAM:
+            return FILTER_ERR_INVALID_PARAM;
+
+        default:
+            return FILTER_ERR_GENERAL;
+    }
+}
+
+/**
+  * @brief This function handles DMA1 channel2 global interrupt (FMAC input).
+  */
+void DMA1_Channel2_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&gDMA_FMACIn_Handle);
+}
+
+/**
+  * @brief This function handles DMA1 channel3 global interrupt (FMAC output).
+  */
+void DMA1_Channel3_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&gDMA_FMACOut_Handle);
+}
+
+/**
+  * @brief This function handles FMAC global interrupt.
+  */
+void FMAC_IRQHandler(void)
+{
+    HAL_FMAC_IRQHandler(&gFMACHandle);
+}
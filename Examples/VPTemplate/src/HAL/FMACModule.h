@@ -0,0 +1,133 @@
+/******************************************************************************
+ * @file FMACModule.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File for the FMAC (filter math accelerator) module
+ *
+ * @details Runs the Q15 FIR and IIR filters of the Filter library on the
+ * FMAC, the samples are moved by DMA in both directions. fmacFilterQ15() is
+ * a backend for filterInitQ15() and waits until the block is filtered.
+ * fmacStartFilterQ15() only starts the transfers and returns, the callback
+ * is called from the DMA interrupt when the output is complete.
+ *
+ * main_app.c chains the potentiometer channel of the ADC DMA stream to the
+ * FMAC: the deferred work of each ADC DMA block converts the samples of the
+ * channel to Q15 and filters them as one block with fmacFilterQ15() as
+ * backend of the filter. For a single channel Q15 ADC buffer the block can
+ * also be started directly from the conversion complete interrupt with
+ * fmacStartFilterQ15(), the CPU then only starts the two DMA transfers per
+ * block.
+ *
+ * The FMAC keeps the state of the filter which used it last. When another
+ * filter is started (or the loaded one has been reset with filterInitQ15()
+ * or filterResetQ15()), the FMAC is reconfigured and preloaded with the
+ * state of the filter, so several filters can share it (with the overhead
+ * of the reconfiguration on each switch).
+ *
+ *
+ *****************************************************************************/
+#ifndef _FMAC_MODULE_H_
+#define _FMAC_MODULE_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Filter/Filter.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define FMAC_ERR_OK                 0               //!< No error occured
+#define FMAC_ERR_INIT_FAILURE       -1              //!< Error during FMAC initialization
+#define FMAC_ERR_INVALID_PARAM      -2              //!< Invalid parameter value
+#define FMAC_ERR_BUSY               -3              //!< A block is still processed
+#define FMAC_ERR_CONFIG             -4              //!< Error during the filter configuration of the FMAC
+#define FMAC_ERR_TRANSFER           -5              //!< Error during the DMA transfer of a block
+#define FMAC_ERR_TIMEOUT            -6              //!< Block not completed in time
+
+#define FMAC_MAX_BLOCK_SIZE         65535           //!< Max. number of samples per block (DMA counter)
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Function pointer which is called from the DMA interrupt when a
+ * block started with fmacStartFilterQ15() is completed
+ */
+typedef void (*FMACBlockCallback)(FilterQ15Data_t* pFilter, int16_t* pOutput, uint32_t count);
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the FMAC and the DMA channels (DMA1 channel 2 for the
+ * input and channel 3 for the output)
+ *
+ * @return Returns FMAC_ERR_OK if no error occured
+ */
+int32_t fmacInitialize();
+
+/**
+ * @brief Starts the filtering of a block of Q15 samples with DMA and
+ * returns immediately
+ *
+ * The buffers must stay valid until the callback was called. The function
+ * must only be called from one context (e.g. the ADC/DMA interrupts, which
+ * have the same priority as the FMAC DMA interrupts).
+ *
+ * @param pFilter       Filter (initialized with filterInitQ15())
+ * @param pInput        Input samples
+ * @param pOutput       Buffer for the filtered samples (may be the same as pInput)
+ * @param count         Number of samples (max. FMAC_MAX_BLOCK_SIZE)
+ * @param pCallback     Function which is called when the block is completed (may be 0)
+ *
+ * @return Returns FMAC_ERR_OK if the block was started, FMAC_ERR_BUSY if
+ * the previous block is not completed yet
+ */
+int32_t fmacStartFilterQ15(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count,
+                           FMACBlockCallback pCallback);
+
+/**
+ * @brief Filter backend for filterInitQ15(), filters a block of Q15
+ * samples with the FMAC and waits for its completion
+ *
+ * @remark: Must not be called from an interrupt
+ *
+ * @param pFilter       Filter (initialized with filterInitQ15())
+ * @param pInput        Input samples
+ * @param pOutput       Buffer for the filtered samples (may be the same as pInput)
+ * @param count         Number of samples (max. FMAC_MAX_BLOCK_SIZE)
+ *
+ * @return Returns FILTER_ERR_OK if no error occured (the FMAC errors are
+ * mapped to the error codes of the Filter library): FILTER_ERR_INVALID_PTR
+ * or FILTER_ERR_INVALID_PARAM for an invalid block or filter,
+ * FILTER_ERR_GENERAL if the FMAC is busy or the block failed
+ */
+int32_t fmacFilterQ15(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count);
+
+/**
+ * @brief Returns whether a block is currently processed
+ *
+ * @return true while a block is processed
+ */
+bool fmacIsBusy();
+
+/**
+ * @brief Stops the FMAC and releases the current filter
+ *
+ * The next block of any filter reloads the filter into the FMAC (as after
+ * a filterResetQ15() of the loaded filter).
+ *
+ * @return Returns FMAC_ERR_OK if no error occured
+ */
+int32_t fmacStopFilter();
+
+
+#endif
@@ -27,16 +27,23 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define TIMER_MAX_DIVIDER           65536       //!< Max. division of the 16bit prescaler and auto reload registers
 
 
 /***** PRIVATE TYPES *********************************************************/
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static int32_t timerInitializeTimestamp();
+static uint32_t timerGetClock();
+static int32_t timerCalculateRate(uint32_t rateHz, uint32_t* pPrescaler, uint32_t* pPeriod, uint32_t* pAchievedMilliHz);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
 static TIM_HandleTypeDef gTimer3Handle;         //! Global handle for Timer 3 (TIM3) peripheral
+static TIM_HandleTypeDef gTimer2Handle;         //! Global handle for Timer 2 (TIM2) peripheral (timestamps)
+static DMA_HandleTypeDef gDMA_Timestamp_Handle; //! Global handle for the DMA of the timestamps (TIM2 CH1)
+static uint32_t gTriggerRateMilliHz = 0;        //! Achieved rate of the ADC trigger in mHz
 
 
 /***** PUBLIC FUNCTIONS ******************************************************/
@@ -45,16 +52,23 @@ int32_t timerInitialize()
 {
     TIM_ClockConfigTypeDef sClockSourceConfig = {0};
     TIM_MasterConfigTypeDef sMasterConfig = {0};
+    uint32_t prescaler;
+    uint32_t period;
 
-    /* Initialize the Timer to get a 10ms cycle
-     * 128 MHz Peripheral Clock ==> divided by Prescaler ==> 128e6 / 1280 = 100000
-     * Timer Frequency of 100.000 = 100kHz to count to 1000 (0-999) and then generate interrupt
-     * ==> 100kHz / 1000 = 100Hz ==> 10ms
+    /* Initialize the Timer to get a 10ms cycle (TIMER_DEFAULT_RATE_HZ)
+     * e.g. 128 MHz Peripheral Clock ==> divided by Prescaler 20 ==> 6.4 MHz
+     * Timer Frequency of 6.4 MHz to count to 64000 and then generate the trigger (TRGO)
+     * ==> 6.4 MHz / 64000 = 100 Hz ==> 10ms
     */
+    if (timerCalculateRate(TIMER_DEFAULT_RATE_HZ, &prescaler, &period, &gTriggerRateMilliHz) != TIMER_ERR_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
     gTimer3Handle.Instance                  = TIM3;
-    gTimer3Handle.Init.Prescaler            = 1280;
+    gTimer3Handle.Init.Prescaler            = prescaler - 1;
     gTimer3Handle.Init.CounterMode          = TIM_COUNTERMODE_UP;
-    gTimer3Handle.Init.Period               = 999;
+    gTimer3Handle.Init.Period               = period - 1;
     gTimer3Handle.Init.ClockDivision        = TIM_CLOCKDIVISION_DIV1;
     gTimer3Handle.Init.AutoReloadPreload    = TIM_AUTORELOAD_PRELOAD_ENABLE;
 
@@ -78,11 +92,85 @@ int32_t timerInitialize()
         return TIMER_ERR_INIT_FAILURE;
     }
 
-    HAL_TIM_Base_Start_IT(&gTimer3Handle);
+    // The timestamp counter must run before the first trigger
+    if (timerInitializeTimestamp() != TIMER_ERR_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    // TIM3 only triggers the ADC by TRGO, no update interrupt is needed
+    HAL_TIM_Base_Start(&gTimer3Handle);
+
+    return TIMER_ERR_OK;
+}
+
+int32_t timerSetTriggerRate(uint32_t rateHz, uint32_t* pAchievedMilliHz)
+{
+    uint32_t prescaler;
+    uint32_t period;
+    uint32_t achievedMilliHz;
+
+    if (timerCalculateRate(rateHz, &prescaler, &period, &achievedMilliHz) != TIMER_ERR_OK)
+    {
+        return TIMER_ERR_INVALID_PARAM;
+    }
+
+    // Both registers are preloaded and take effect with the next update event
+    __HAL_TIM_SET_PRESCALER(&gTimer3Handle, prescaler - 1);
+    __HAL_TIM_SET_AUTORELOAD(&gTimer3Handle, period - 1);
+
+    gTriggerRateMilliHz = achievedMilliHz;
+
+    if (pAchievedMilliHz != 0)
+        *pAchievedMilliHz = achievedMilliHz;
 
     return TIMER_ERR_OK;
 }
 
+uint32_t timerGetTriggerRate()
+{
+    return gTriggerRateMilliHz;
+}
+
+uint32_t timerGetTimestamp()
+{
+    return __HAL_TIM_GET_COUNTER(&gTimer2Handle);
+}
+
+int32_t timerStartTriggerCapture(uint32_t* pBuffer, uint32_t count)
+{
+    if (pBuffer == 0)
+        return TIMER_ERR_INVALID_PTR;
+
+    // The DMA runs circular without interrupts (DMA1_Channel4_IRQn is not enabled)
+    if (HAL_TIM_IC_Start_DMA(&gTimer2Handle, TIM_CHANNEL_1, pBuffer, count) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    return TIMER_ERR_OK;
+}
+
+void timerStopTriggerCapture()
+{
+    HAL_TIM_IC_Stop_DMA(&gTimer2Handle, TIM_CHANNEL_1);
+
+    // The counter keeps running for timerGetTimestamp()
+    __HAL_TIM_ENABLE(&gTimer2Handle);
+}
+
+void timerSetTriggerEnabled(bool enabled)
+{
+    if (enabled)
+    {
+        __HAL_TIM_ENABLE(&gTimer3Handle);
+    }
+    else
+    {
+        __HAL_TIM_DISABLE(&gTimer3Handle);
+    }
+}
+
 /**
 * @brief TIM_Base MSP Initialization
 * This function configures the hardware resources used in this example
@@ -98,20 +186,151 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* htim_base)
     {
         /* Peripheral clock enable */
         __HAL_RCC_TIM3_CLK_ENABLE();
-
-        /* TIM3 interrupt Init */
-        HAL_NVIC_SetPriority(TIM3_IRQn, 2, 0);
-        HAL_NVIC_EnableIRQ(TIM3_IRQn);
     }
 }
 
 /**
-  * @brief This function handles TIM3 global interrupt.
-  */
-void TIM3_IRQHandler(void)
+* @brief TIM_IC MSP Initialization
+* This function configures the clock and the DMA of the timestamp timer
+*
+* @param htim_ic: TIM_IC handle pointer
+*
+* @remark: this HAL_TIM_IC_MspInit function is called automatically by the
+* STM32 HAL library
+*/
+void HAL_TIM_IC_MspInit(TIM_HandleTypeDef* htim_ic)
 {
-    HAL_TIM_IRQHandler(&gTimer3Handle);
+    if(htim_ic->Instance==TIM2)
+    {
+        /* Peripheral clock enable */
+        __HAL_RCC_TIM2_CLK_ENABLE();
+        __HAL_RCC_DMAMUX1_CLK_ENABLE();
+        __HAL_RCC_DMA1_CLK_ENABLE();
+
+        /* TIM2 CH1 DMA Init (capture register to memory, circular) */
+        gDMA_Timestamp_Handle.Instance                  = DMA1_Channel4;
+        gDMA_Timestamp_Handle.Init.Request              = DMA_REQUEST_TIM2_CH1;
+        gDMA_Timestamp_Handle.Init.Direction            = DMA_PERIPH_TO_MEMORY;
+        gDMA_Timestamp_Handle.Init.PeriphInc            = DMA_PINC_DISABLE;
+        gDMA_Timestamp_Handle.Init.MemInc               = DMA_MINC_ENABLE;
+        gDMA_Timestamp_Handle.Init.PeriphDataAlignment  = DMA_PDATAALIGN_WORD;
+        gDMA_Timestamp_Handle.Init.MemDataAlignment     = DMA_MDATAALIGN_WORD;
+        gDMA_Timestamp_Handle.Init.Mode                 = DMA_CIRCULAR;
+        gDMA_Timestamp_Handle.Init.Priority             = DMA_PRIORITY_LOW;
+
+        if (HAL_DMA_Init(&gDMA_Timestamp_Handle) != HAL_OK)
+        {
+            Error_Handler();
+        }
+
+        __HAL_LINKDMA(htim_ic, hdma[TIM_DMA_ID_CC1], gDMA_Timestamp_Handle);
+    }
 }
 
 
 /***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Initializes TIM2 as free running timestamp counter, which
+ * captures its value on each TRGO of TIM3
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, otherwiese TIMER_ERR_INIT_FAILURE
+ */
+static int32_t timerInitializeTimestamp()
+{
+    TIM_SlaveConfigTypeDef sSlaveConfig = {0};
+    TIM_IC_InitTypeDef sConfigIC = {0};
+
+    /* e.g. 128 MHz Peripheral Clock ==> divided by Prescaler + 1 = 128 ==> 1 MHz,
+     * counting over the full 32bit range
+     */
+    gTimer2Handle.Instance                  = TIM2;
+    gTimer2Handle.Init.Prescaler            = (timerGetClock() / TIMER_TIMESTAMP_HZ) - 1;
+    gTimer2Handle.Init.CounterMode          = TIM_COUNTERMODE_UP;
+    gTimer2Handle.Init.Period               = 0xFFFFFFFF;
+    gTimer2Handle.Init.ClockDivision        = TIM_CLOCKDIVISION_DIV1;
+    gTimer2Handle.Init.AutoReloadPreload    = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+    if (HAL_TIM_IC_Init(&gTimer2Handle) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    // TRGO of TIM3 is the internal trigger ITR2 of TIM2, it is only used
+    // as capture input (TRC), the counter isn't controlled by it
+    sSlaveConfig.SlaveMode      = TIM_SLAVEMODE_DISABLE;
+    sSlaveConfig.InputTrigger   = TIM_TS_ITR2;
+
+    if (HAL_TIM_SlaveConfigSynchro(&gTimer2Handle, &sSlaveConfig) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    sConfigIC.ICPolarity    = TIM_ICPOLARITY_RISING;
+    sConfigIC.ICSelection   = TIM_ICSELECTION_TRC;
+    sConfigIC.ICPrescaler   = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter      = 0;
+
+    if (HAL_TIM_IC_ConfigChannel(&gTimer2Handle, &sConfigIC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        return TIMER_ERR_INIT_FAILURE;
+    }
+
+    __HAL_TIM_ENABLE(&gTimer2Handle);
+
+    return TIMER_ERR_OK;
+}
+
+/**
+ * @brief Returns the clock of the APB1 timers (TIM2, TIM3)
+ *
+ * The timers run with twice the APB1 clock, if APB1 is divided from HCLK
+ *
+ * @return Timer clock in Hz
+ */
+static uint32_t timerGetClock()
+{
+    uint32_t clock = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        clock *= 2;
+    }
+
+    return clock;
+}
+
+/**
+ * @brief Calculates prescaler and period of TIM3 for a trigger rate
+ *
+ * @param rateHz            Requested rate (1 Hz .. TIMER_MAX_RATE_HZ, max. half of the timer clock)
+ * @param pPrescaler        Division of the prescaler (register value + 1)
+ * @param pPeriod           Division of the period (register value + 1)
+ * @param pAchievedMilliHz  Achieved rate in mHz
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, TIMER_ERR_INVALID_PARAM
+ * if the rate is out of range
+ */
+static int32_t timerCalculateRate(uint32_t rateHz, uint32_t* pPrescaler, uint32_t* pPeriod, uint32_t* pAchievedMilliHz)
+{
+    uint32_t clock = timerGetClock();
+
+    if (rateHz == 0 || rateHz > TIMER_MAX_RATE_HZ || rateHz > clock / 2)
+        return TIMER_ERR_INVALID_PARAM;
+
+    // Smallest prescaler, which keeps the period within 16 bits
+    uint32_t ticks = (clock + rateHz / 2) / rateHz;
+    uint32_t prescaler = (ticks + TIMER_MAX_DIVIDER - 1) / TIMER_MAX_DIVIDER;
+    uint64_t divider = (uint64_t)prescaler * rateHz;
+    uint32_t period = (uint32_t)((clock + divider / 2) / divider);
+
+    if (period > TIMER_MAX_DIVIDER)
+        period = TIMER_MAX_DIVIDER;
+
+    *pPrescaler = prescaler;
+    *pPeriod = period;
+    *pAchievedMilliHz = (uint32_t)(((uint64_t)clock * 1000 + (uint64_t)prescaler * period / 2)
+                                   / ((uint64_t)prescaler * period));
+
+    return TIMER_ERR_OK;
+}
@@ -10,6 +10,15 @@
  *
  * @brief Header file for the Timer Module
  *
+ * @details TIM3 triggers the ADC conversions with its update event
+ * (TRGO). Its prescaler and period are calculated at runtime from the
+ * actual timer clock (SystemCoreClock and APB1 prescaler), for rates from
+ * 1 Hz up to TIMER_MAX_RATE_HZ. TIM2 is a free running 32bit counter with TIMER_TIMESTAMP_HZ,
+ * which latches its value on each TRGO of TIM3 in the capture register of
+ * channel 1 in hardware. With timerStartTriggerCapture() the DMA copies
+ * these timestamps into a circular buffer, so each trigger gets the exact
+ * time, independent of the interrupt latency.
+ *
  *
  *****************************************************************************/
 
@@ -19,6 +28,7 @@
 
 /***** INCLUDES **************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 
 /***** CONSTANTS *************************************************************/
 
@@ -26,6 +36,27 @@
 /***** MACROS ****************************************************************/
 #define TIMER_ERR_OK                  0         //!< No error occured
 #define TIMER_ERR_INIT_FAILURE        -1        //!< Error during timer initialization
+#define TIMER_ERR_INVALID_PTR         -2        //!< Invalid pointer
+#define TIMER_ERR_INVALID_PARAM       -3        //!< Invalid parameter value
+
+#define TIMER_DEFAULT_RATE_HZ         100       //!< Rate of the TIM3 update events (ADC trigger) after timerInitialize()
+#define TIMER_MAX_RATE_HZ             1000000   //!< Max. rate of the TIM3 update events
+
+/**
+ * @brief Default rate of the ADC trigger in Hz, as constant for the filter
+ * design macros (Filter/FilterDesign.h). Exact at the timer clock of
+ * 128 MHz (prescaler 20, period 64000).
+ *
+ * This is only the rate after timerInitialize(), not the current one
+ * (see timerGetTriggerRate()). Coefficients designed with it at build time,
+ * like gPotFilterAlpha and the potentiometer biquad of main_app.c, are
+ * wrong at any other rate: a caller of adcSetSampleRate() or
+ * timerSetTriggerRate() must recompute them for the achieved rate, or
+ * reject the rate change.
+ */
+#define TIMER_SAMPLE_RATE_HZ          ((double)TIMER_DEFAULT_RATE_HZ)
+
+#define TIMER_TIMESTAMP_HZ            1000000   //!< Clock of the timestamps (TIM2), wraps around after 71.6 minutes
 
 
 /***** TYPES *****************************************************************/
@@ -40,4 +71,65 @@
  */
 int32_t timerInitialize();
 
+/**
+ * @brief Sets the rate of the TIM3 update events (ADC trigger)
+ *
+ * Prescaler and period are calculated from the actual timer clock, the
+ * smallest prescaler is used for the finest resolution of the period. The
+ * new rate takes effect after the current period (no additional trigger).
+ *
+ * @param rateHz            Requested rate (1 Hz .. TIMER_MAX_RATE_HZ)
+ * @param pAchievedMilliHz  Achieved rate in mHz (may be 0)
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, TIMER_ERR_INVALID_PARAM
+ * if the rate is out of range
+ */
+int32_t timerSetTriggerRate(uint32_t rateHz, uint32_t* pAchievedMilliHz);
+
+/**
+ * @brief Returns the achieved rate of the TIM3 update events (ADC trigger)
+ *
+ * @return Rate in mHz
+ */
+uint32_t timerGetTriggerRate();
+
+/**
+ * @brief Returns the current value of the free running timestamp counter
+ *
+ * @return Timestamp in ticks of TIMER_TIMESTAMP_HZ (differences are
+ * calculated with unsigned subtraction)
+ */
+uint32_t timerGetTimestamp();
+
+/**
+ * @brief Starts the transfer of the timestamps of the TIM3 triggers into a
+ * circular buffer by DMA
+ *
+ * Entry n of the buffer is the timestamp of the n-th trigger after the
+ * start (modulo count). Use timerSetTriggerEnabled() to start it in sync
+ * with the consumer of the triggers.
+ *
+ * @param pBuffer       Buffer for the timestamps
+ * @param count         Number of timestamps in the buffer
+ *
+ * @return Returns TIMER_ERR_OK if no error occured, TIMER_ERR_INVALID_PTR
+ * for a null pointer, TIMER_ERR_INIT_FAILURE if the DMA could not be started
+ */
+int32_t timerStartTriggerCapture(uint32_t* pBuffer, uint32_t count);
+
+/**
+ * @brief Stops the transfer of the timestamps
+ */
+void timerStopTriggerCapture();
+
+/**
+ * @brief Enables or disables the triggers (counter of TIM3)
+ *
+ * While disabled no trigger and no timestamp are generated, e.g. to start
+ * the ADC and the timestamp DMA without a trigger in between
+ *
+ * @param enabled       Flag whether the triggers are enabled
+ */
+void timerSetTriggerEnabled(bool enabled);
+
 #endif
@@ -100,7 +100,8 @@ int32_t uartInitialize(uint32_t baudrate)
         Error_Handler();
     }
 
-    if (HAL_UARTEx_DisableFifoMode(&gUARTHandle) != HAL_OK)
+    // The RX FIFO buffers some bytes, if the data is polled by a cyclic task
+    if (HAL_UARTEx_EnableFifoMode(&gUARTHandle) != HAL_OK)
     {
         Error_Handler();
     }
@@ -140,6 +141,13 @@ int32_t uartHasData(int8_t* pHasData)
 {
 	int32_t result = UART_ERR_OK;
 
+	// An overrun blocks the reception of further bytes, so it is cleared
+	// here (the bytes in the FIFO stay available)
+	if (__HAL_UART_GET_FLAG(&gUARTHandle, UART_FLAG_ORE)==SET)
+	{
+		__HAL_UART_CLEAR_OREFLAG(&gUARTHandle);
+	}
+
 	if (__HAL_UART_GET_FLAG(&gUARTHandle, UART_FLAG_RXNE)==SET)
 	{
 		*pHasData = 1;
@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @file Coroutine.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Stackless coroutines (protothreads) for cyclic tasks
+ *
+ * @details The macros turn a cyclic task function into a coroutine, which
+ * returns to the scheduler while it waits and continues at the same position
+ * on its next call. This replaces blocking calls like HAL_Delay() in multi
+ * step sequences without the RAM for an own stack per task.
+ *
+ *   static TaskContext gContext = TASK_CONTEXT_INIT(HAL_GetTick);
+ *
+ *   void taskSequence()
+ *   {
+ *       TASK_BEGIN(&gContext);
+ *       ledToggleLED(LED0);
+ *       TASK_SLEEP(&gContext, 100);
+ *       TASK_YIELD_UNTIL(&gContext, buttonGetButtonStatus(BTN_SW1) == BUTTON_PRESSED);
+ *       ledToggleLED(LED1);
+ *       TASK_END(&gContext);
+ *   }
+ *
+ * The resume position is stored as source line in a switch statement, so
+ * these rules apply:
+ *  - Local variables are not preserved across a yield, use static ones
+ *  - Only one yield per source line
+ *  - No yield inside an own switch statement of the coroutine
+ *  - The function must return void (e.g. a CyclicFunction)
+ *
+ * A coroutine can't wait with a higher resolution than the period it is
+ * called with, e.g. TASK_SLEEP() in a 25ms task is rounded up to 25ms.
+ *
+ *
+ *****************************************************************************/
+#ifndef _COROUTINE_H_
+#define _COROUTINE_H_
+
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "Scheduler.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+
+/**
+ * @brief Static initializer of a coroutine context
+ *
+ * @param getHALTick    Function to read the HAL tick (used by TASK_SLEEP)
+ */
+#define TASK_CONTEXT_INIT(getHALTick)       { 0, 0, (getHALTick) }
+
+/**
+ * @brief Starts the body of a coroutine, must be the first statement
+ */
+#define TASK_BEGIN(pContext)                switch ((pContext)->resumeLine) { case 0:
+
+/**
+ * @brief Ends the body of a coroutine, the next call starts from the
+ * beginning again
+ */
+#define TASK_END(pContext)                  } (pContext)->resumeLine = 0
+
+/**
+ * @brief Returns to the scheduler, the next call continues after this
+ * statement
+ */
+#define TASK_YIELD(pContext)                                                    \
+    do {                                                                        \
+        (pContext)->resumeLine = __LINE__; return; case __LINE__: ;             \
+    } while (0)
+
+/**
+ * @brief Returns to the scheduler until the condition is true, the
+ * condition is evaluated once per call
+ */
+#define TASK_YIELD_UNTIL(pContext, condition)                                   \
+    do {                                                                        \
+        (pContext)->resumeLine = __LINE__; case __LINE__:                       \
+        if (!(condition)) return;                                               \
+    } while (0)
+
+/**
+ * @brief Returns to the scheduler until the given number of HAL ticks
+ * has elapsed (wrap around safe)
+ */
+#define TASK_SLEEP(pContext, ticks)                                             \
+    do {                                                                        \
+        (pContext)->wakeTick = (pContext)->pGetHALTick() + (uint32_t)(ticks);   \
+        TASK_YIELD_UNTIL(pContext, (int32_t)((pContext)->pGetHALTick() - (pContext)->wakeTick) >= 0); \
+    } while (0)
+
+/**
+ * @brief Restarts the coroutine from the beginning on the next call, can
+ * also be used from outside of the coroutine
+ */
+#define TASK_RESET(pContext)                ((pContext)->resumeLine = 0)
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief State of a stackless coroutine
+ *
+ */
+typedef struct _TaskContext
+{
+    uint32_t resumeLine;                //!< Source line to continue at (0 = beginning)
+    uint32_t wakeTick;                  //!< HAL tick at which TASK_SLEEP() continues
+    GetHALTick pGetHALTick;             //!< Function pointer to read the current HAL tick
+} TaskContext;
+
+
+/***** PROTOTYPES ************************************************************/
+
+
+#endif
@@ -0,0 +1,309 @@
+/******************************************************************************
+ * @file Kernel.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the preemptive fixed-priority kernel
+ *
+ * @details All kernel data is only modified by the SysTick, SVC and PendSV
+ * handlers. These are configured to the same (lowest) priority, so they can't
+ * preempt each other and no interrupt lock is needed.
+ *
+ * The context switch only saves r4-r11 and EXC_RETURN by software, the other
+ * registers are stacked by the hardware on exception entry. If the project is
+ * built for hard-float, s16-s31 are only saved for tasks which actually used
+ * the FPU (EXC_RETURN bit 4 cleared), s0-s15 are handled by the lazy stacking
+ * of the core.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "stm32g4xx.h"
+
+#include "Kernel.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define KERNEL_IDLE_PRIORITY        31          //!< Priority (bit in ready mask) of the idle task
+#define KERNEL_HANDLER_STACK_WORDS  256         //!< Size of the main stack used by the exception handlers
+
+#define KERNEL_INITIAL_XPSR         0x01000000  //!< xPSR of a new task (Thumb bit set)
+#define KERNEL_INITIAL_EXC_RETURN   0xFFFFFFFD  //!< Return to thread mode, use PSP, no FPU frame
+
+#define KERNEL_IRQ_PRIORITY         ((1UL << __NVIC_PRIO_BITS) - 1UL)   //!< Priority of SysTick, SVC and PendSV
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void kernelTaskEntry(KernelTask* pSelf);
+static void kernelSchedule(void);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static KernelTask gKernelTasks[KERNEL_MAX_TASKS];       //!< Task table indexed by priority
+static KernelTask gKernelIdleTask;                      //!< Task control block for the caller of kernelStart()
+
+static uint32_t gKernelTaskMask;                        //!< Bit mask of the registered priorities
+static volatile uint32_t gKernelReadyMask;              //!< Bit mask of the released priorities
+static volatile uint32_t gKernelRunning;                //!< Flag whether kernelStart() has been called
+
+/**
+ * @brief Current and next task, both are accessed by the context switch in
+ * assembler
+ */
+static KernelTask* volatile gKernelCurrent __attribute__((used));
+static KernelTask* volatile gKernelNext __attribute__((used));
+
+/**
+ * @brief Stack used by all exception handlers after the kernel has been
+ * started (the original main stack is used by the idle task)
+ */
+static uint32_t gKernelHandlerStack[KERNEL_HANDLER_STACK_WORDS] __attribute__((aligned(8)));
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+int32_t kernelInitialize(void)
+{
+    if (gKernelRunning != 0)
+        return KERNEL_ERR_RUNNING;
+
+    for (int32_t i = 0; i < KERNEL_MAX_TASKS; i++)
+    {
+        gKernelTasks[i].pStackPointer   = 0;
+        gKernelTasks[i].pTask           = 0;
+        gKernelTasks[i].period          = 0;
+        gKernelTasks[i].countdown       = 0;
+        gKernelTasks[i].priority        = i;
+        gKernelTasks[i].overrunCount    = 0;
+    }
+
+    gKernelIdleTask.pStackPointer   = 0;
+    gKernelIdleTask.pTask           = 0;
+    gKernelIdleTask.priority        = KERNEL_IDLE_PRIORITY;
+
+    gKernelTaskMask     = 0;
+    gKernelReadyMask    = (1UL << KERNEL_IDLE_PRIORITY);
+    gKernelCurrent      = &gKernelIdleTask;
+    gKernelNext         = &gKernelIdleTask;
+
+    return KERNEL_ERR_OK;
+}
+
+
+int32_t kernelAddTask(CyclicFunction pTask, uint32_t period, uint32_t phase, uint32_t priority,
+                      uint32_t* pStack, uint32_t stackWords)
+{
+    if (pTask == 0 || pStack == 0)
+        return KERNEL_ERR_INVALID_PTR;
+
+    if (period == 0 || priority >= KERNEL_MAX_TASKS || stackWords < KERNEL_MIN_STACK_WORDS)
+        return KERNEL_ERR_INVALID_PARAM;
+
+    if (gKernelRunning != 0)
+        return KERNEL_ERR_RUNNING;
+
+    if ((gKernelTaskMask & (1UL << priority)) != 0)
+        return KERNEL_ERR_PRIO_USED;
+
+    KernelTask* pEntry = &gKernelTasks[priority];
+
+    // Prepare the initial stack frame, as if the task had been interrupted
+    // right before the first instruction of kernelTaskEntry()
+    uint32_t* pStackPointer = (uint32_t*)(((uint32_t)&pStack[stackWords]) & ~7UL);
+
+    *(--pStackPointer) = KERNEL_INITIAL_XPSR;                   // xPSR
+    *(--pStackPointer) = ((uint32_t)kernelTaskEntry) & ~1UL;    // PC
+    *(--pStackPointer) = 0;                                     // LR (task entry never returns)
+    *(--pStackPointer) = 0;                                     // R12
+    *(--pStackPointer) = 0;                                     // R3
+    *(--pStackPointer) = 0;                                     // R2
+    *(--pStackPointer) = 0;                                     // R1
+    *(--pStackPointer) = (uint32_t)pEntry;                      // R0 = argument of kernelTaskEntry()
+
+    *(--pStackPointer) = KERNEL_INITIAL_EXC_RETURN;             // EXC_RETURN
+    for (int32_t i = 0; i < 8; i++)
+    {
+        *(--pStackPointer) = 0;                                 // R11 - R4
+    }
+
+    pEntry->pStackPointer   = pStackPointer;
+    pEntry->pTask           = pTask;
+    pEntry->period          = period;
+    pEntry->overrunCount    = 0;
+
+    // A task without phase is released immediately
+    if (phase == 0)
+    {
+        pEntry->countdown = period;
+        gKernelReadyMask |= (1UL << priority);
+    }
+    else
+    {
+        pEntry->countdown = phase;
+    }
+
+    gKernelTaskMask |= (1UL << priority);
+
+    return KERNEL_ERR_OK;
+}
+
+
+int32_t kernelStart(void)
+{
+    if (gKernelRunning != 0)
+        return KERNEL_ERR_RUNNING;
+
+    NVIC_SetPriority(SVCall_IRQn, KERNEL_IRQ_PRIORITY);
+    NVIC_SetPriority(PendSV_IRQn, KERNEL_IRQ_PRIORITY);
+    NVIC_SetPriority(SysTick_IRQn, KERNEL_IRQ_PRIORITY);
+
+    // Continue on the process stack with the current stack pointer value, and
+    // move the exception handlers to their own main stack
+    __set_PSP(__get_MSP());
+    __set_CONTROL(__get_CONTROL() | CONTROL_SPSEL_Msk);
+    __ISB();
+    __set_MSP((uint32_t)&gKernelHandlerStack[KERNEL_HANDLER_STACK_WORDS]);
+
+    gKernelCurrent  = &gKernelIdleTask;
+    gKernelRunning  = 1;
+
+    // Let the tasks which are already released run
+    __ASM volatile ("svc #0" ::: "memory");
+
+    return KERNEL_ERR_OK;
+}
+
+
+uint32_t kernelGetOverrunCount(uint32_t priority)
+{
+    if (priority >= KERNEL_MAX_TASKS)
+        return 0;
+
+    return gKernelTasks[priority].overrunCount;
+}
+
+
+void kernelTick(void)
+{
+    if (gKernelRunning == 0)
+        return;
+
+    uint32_t taskMask = gKernelTaskMask;
+
+    while (taskMask != 0)
+    {
+        uint32_t priority = __CLZ(__RBIT(taskMask));
+        KernelTask* pTask = &gKernelTasks[priority];
+
+        taskMask &= ~(1UL << priority);
+
+        if (--pTask->countdown == 0)
+        {
+            pTask->countdown = pTask->period;
+
+            // A task which is still ready hasn't finished its last release
+            if ((gKernelReadyMask & (1UL << priority)) != 0)
+                pTask->overrunCount++;
+            else
+                gKernelReadyMask |= (1UL << priority);
+        }
+    }
+
+    kernelSchedule();
+}
+
+
+void kernelHandleSVC(void)
+{
+    // The idle task never finishes, it only issues the SVC to start the kernel
+    if (gKernelCurrent != &gKernelIdleTask)
+        gKernelReadyMask &= ~(1UL << gKernelCurrent->priority);
+
+    kernelSchedule();
+}
+
+
+__attribute__((naked)) void kernelPendSV(void)
+{
+    __ASM volatile (
+        "   mrs     r0, psp                 \n"
+        "   ldr     r3, =gKernelCurrent     \n"
+        "   ldr     r2, [r3]                \n"
+#if (__FPU_USED == 1U)
+        "   tst     lr, #0x10               \n"
+        "   it      eq                      \n"
+        "   vstmdbeq r0!, {s16-s31}         \n"
+#endif
+        "   stmdb   r0!, {r4-r11, lr}       \n"
+        "   str     r0, [r2]                \n"
+        "   ldr     r1, =gKernelNext        \n"
+        "   ldr     r2, [r1]                \n"
+        "   str     r2, [r3]                \n"
+        "   ldr     r0, [r2]                \n"
+        "   ldmia   r0!, {r4-r11, lr}       \n"
+#if (__FPU_USED == 1U)
+        "   tst     lr, #0x10               \n"
+        "   it      eq                      \n"
+        "   vldmiaeq r0!, {s16-s31}         \n"
+#endif
+        "   msr     psp, r0                 \n"
+        "   isb                             \n"
+        "   bx      lr                      \n"
+        "   .ltorg                          \n"
+    );
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Entry function of every kernel task
+ *
+ * Executes the cyclic function once per release and reports the end of
+ * the execution to the kernel via SVC.
+ *
+ * @param pSelf         Task control block of the task
+ */
+static void kernelTaskEntry(KernelTask* pSelf)
+{
+    while (1)
+    {
+        pSelf->pTask();
+
+        __ASM volatile ("svc #0" ::: "memory");
+    }
+}
+
+/**
+ * @brief Selects the released task with the highest priority and
+ * requests a context switch if it isn't the current task
+ *
+ */
+static void kernelSchedule(void)
+{
+    uint32_t priority = __CLZ(__RBIT(gKernelReadyMask));
+
+    if (priority == KERNEL_IDLE_PRIORITY)
+        gKernelNext = &gKernelIdleTask;
+    else
+        gKernelNext = &gKernelTasks[priority];
+
+    if (gKernelNext != gKernelCurrent)
+    {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
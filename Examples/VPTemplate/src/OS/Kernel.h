@@ -0,0 +1,139 @@
+/******************************************************************************
+ * @file Kernel.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File for the preemptive fixed-priority kernel
+ *
+ * @details The kernel is an alternative to the cooperative scheduler. Each
+ * cyclic task runs on its own stack and is released from the SysTick
+ * handler. A released task preempts all tasks with a lower priority, the
+ * context switch itself is done in the PendSV handler. The code which
+ * calls kernelStart() (normally main) continues as idle task with the
+ * lowest priority.
+ *
+ * The kernel is only hooked into the exception handlers if the project is
+ * built with OS_KERNEL_PREEMPTIVE defined.
+ *
+ *
+ *****************************************************************************/
+#ifndef _KERNEL_H_
+#define _KERNEL_H_
+
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#include "Scheduler.h"
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define KERNEL_ERR_OK               0           //!< No error occured (Kernel)
+#define KERNEL_ERR_INVALID_PTR      -1          //!< Invalid pointer (Kernel)
+#define KERNEL_ERR_INVALID_PARAM    -2          //!< Invalid parameter value (Kernel)
+#define KERNEL_ERR_PRIO_USED        -3          //!< Priority is already used by another task (Kernel)
+#define KERNEL_ERR_RUNNING          -4          //!< Kernel is already running (Kernel)
+
+#ifndef KERNEL_MAX_TASKS
+#define KERNEL_MAX_TASKS            8           //!< Number of task priorities (max. 31)
+#endif
+
+#define KERNEL_MIN_STACK_WORDS      64          //!< Minimum stack size of a task in 32bit words
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Task control block of a kernel task
+ *
+ * @remark: pStackPointer must be the first member, it is accessed by
+ * the context switch in assembler.
+ *
+ */
+typedef struct _KernelTask
+{
+    uint32_t* pStackPointer;            //!< Saved process stack pointer of the task
+    CyclicFunction pTask;               //!< Function pointer to the cyclic task function
+    uint32_t period;                    //!< Period of the task in SysTicks
+    uint32_t countdown;                 //!< Remaining SysTicks until the next release
+    uint32_t priority;                  //!< Priority of the task (0 = highest)
+    uint32_t overrunCount;              //!< Number of releases which were lost because the task was still running
+} KernelTask;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the kernel and clears the task table
+ *
+ * @return KERNEL_ERR_OK if no error occured
+ */
+int32_t kernelInitialize(void);
+
+/**
+ * @brief Registers a cyclic task at the kernel
+ *
+ * The first release of the task is after "phase" SysTicks (immediately for
+ * a phase of 0), all further releases follow with the given period.
+ *
+ * @param pTask         Cyclic function which should be called
+ * @param period        Period of the task in SysTicks (must be > 0)
+ * @param phase         Offset of the first release in SysTicks
+ * @param priority      Unique priority of the task (0 = highest, < KERNEL_MAX_TASKS)
+ * @param pStack        Memory used as stack for this task
+ * @param stackWords    Size of the stack in 32bit words
+ *
+ * @return KERNEL_ERR_OK if no error occured
+ */
+int32_t kernelAddTask(CyclicFunction pTask, uint32_t period, uint32_t phase, uint32_t priority,
+                      uint32_t* pStack, uint32_t stackWords);
+
+/**
+ * @brief Starts the kernel
+ *
+ * The caller is switched to the process stack and continues as idle task.
+ * All other tasks preempt the idle task as soon as they are released.
+ *
+ * @return KERNEL_ERR_OK if no error occured
+ */
+int32_t kernelStart(void);
+
+/**
+ * @brief Returns the number of lost releases of a task
+ *
+ * @param priority      Priority of the task
+ *
+ * @return Number of overruns
+ */
+uint32_t kernelGetOverrunCount(uint32_t priority);
+
+/**
+ * @brief Releases the due tasks, must be called from the SysTick handler
+ *
+ */
+void kernelTick(void);
+
+/**
+ * @brief Handles a supervisor call of a task, must be called from the
+ * SVC handler
+ *
+ * The only service is "task finished", which is issued by a task as
+ * soon as its cyclic function returned.
+ *
+ */
+void kernelHandleSVC(void);
+
+/**
+ * @brief Performs the context switch, must be entered from the PendSV
+ * handler by a branch (no function call) to keep the exception state
+ *
+ */
+void kernelPendSV(void);
+
+#endif
@@ -8,8 +8,8 @@
  *
  ******************************************************************************
  *
- * @brief Implementation of the cooperative scheduler with a  pre-defined set
- * of cyclic "task slots"
+ * @brief Implementation of the cooperative scheduler based on a table of
+ * cyclic tasks with arbitrary period and phase
  *
  *
  *****************************************************************************/
@@ -23,17 +23,28 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
-#define HAL_TICK_VALUE_1MS      1       //!< Number of HAL Ticks used for 1ms Tasks
-#define HAL_TICK_VALUE_10MS     10      //!< Number of HAL Ticks used for 10ms Tasks
-#define HAL_TICK_VALUE_100MS    100     //!< Number of HAL Ticks used for 100ms Tasks
-#define HAL_TICK_VALUE_250MS    250     //!< Number of HAL Ticks used for 250ms Tasks
-#define HAL_TICK_VALUE_1000MS   1000    //!< Number of HAL Ticks used for 1000ms Tasks
+
+/**
+ * @brief Checks whether HAL tick a is before HAL tick b
+ *
+ * The check is done on the signed difference, so it stays valid as long as
+ * both time stamps are less than 2^31 ticks apart.
+ */
+#define SCHED_TICK_BEFORE(a, b)     ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
 
 
 /***** PRIVATE TYPES *********************************************************/
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static void schedInsertDueList(Scheduler* pScheduler, SchedulerTask* pTask);
+static void schedRunDeferredWork(Scheduler* pScheduler);
+static void schedRunFrame(Scheduler* pScheduler);
+static uint32_t schedGCD(uint32_t a, uint32_t b);
+static uint64_t schedMaxReleaseLoad(const uint32_t* pLoad, const uint32_t* pCoReleased, uint32_t candidates);
+static uint32_t schedCalcNextRelease(SchedulerTask* pTask, uint32_t releaseTick, uint32_t halTick);
+static void schedClearTaskStats(SchedulerTask* pTask);
+static void schedUpdateTaskStats(SchedulerTask* pTask, uint32_t execCycles, uint32_t jitter, bool overrun);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
@@ -44,6 +55,219 @@
 
 int32_t schedInitialize(Scheduler* pScheduler)
 {
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    for (int32_t i = 0; i < SCHED_MAX_TASKS; i++)
+    {
+        pScheduler->tasks[i].pTask          = 0;
+        pScheduler->tasks[i].period         = 0;
+        pScheduler->tasks[i].phase          = 0;
+        pScheduler->tasks[i].nextRelease    = 0;
+        pScheduler->tasks[i].policy         = SCHED_POLICY_SKIP;
+        pScheduler->tasks[i].maxCatchUp     = 0;
+        pScheduler->tasks[i].pNext          = 0;
+
+        schedClearTaskStats(&(pScheduler->tasks[i]));
+    }
+
+    for (int32_t i = 0; i < SCHED_MAX_WORK_QUEUES; i++)
+    {
+        pScheduler->pWorkQueues[i] = 0;
+    }
+
+    pScheduler->taskCount       = 0;
+    pScheduler->pDueList        = 0;
+    pScheduler->workQueueCount  = 0;
+    pScheduler->workBudget      = SCHED_DEFAULT_WORK_BUDGET;
+
+    pScheduler->pFrameTable         = 0;
+    pScheduler->frameIndex          = 0;
+    pScheduler->nextFrame           = 0;
+    pScheduler->frameOverrunCount   = 0;
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedAddTask(Scheduler* pScheduler, CyclicFunction pTask, uint32_t period, uint32_t phase)
+{
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0 || pTask == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (period == 0)
+        return SCHED_ERR_INVALID_PARAM;
+
+    if (pScheduler->taskCount >= SCHED_MAX_TASKS)
+        return SCHED_ERR_TABLE_FULL;
+
+    int32_t taskID = pScheduler->taskCount;
+    SchedulerTask* pEntry = &(pScheduler->tasks[taskID]);
+
+    pEntry->pTask       = pTask;
+    pEntry->period      = period;
+    pEntry->phase       = phase;
+    pEntry->nextRelease = pScheduler->pGetHALTick() + phase;
+    pEntry->policy      = SCHED_POLICY_SKIP;
+    pEntry->maxCatchUp  = 0;
+    pEntry->pNext       = 0;
+    schedClearTaskStats(pEntry);
+
+    schedInsertDueList(pScheduler, pEntry);
+    pScheduler->taskCount++;
+
+    return taskID;
+}
+
+
+int32_t schedSetTaskPolicy(Scheduler* pScheduler, int32_t taskID, SchedulerPolicy policy, uint32_t maxCatchUp)
+{
+    if (pScheduler == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (taskID < 0 || taskID >= pScheduler->taskCount)
+        return SCHED_ERR_INVALID_PARAM;
+
+    if (policy != SCHED_POLICY_SKIP && policy != SCHED_POLICY_REPHASE && policy != SCHED_POLICY_CATCH_UP)
+        return SCHED_ERR_INVALID_PARAM;
+
+    pScheduler->tasks[taskID].policy      = policy;
+    pScheduler->tasks[taskID].maxCatchUp  = maxCatchUp;
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedSpreadPhases(Scheduler* pScheduler)
+{
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (pScheduler->taskCount == 0)
+        return SCHED_ERR_NO_TASK;
+
+    int32_t taskCount = pScheduler->taskCount;
+    uint32_t load[SCHED_MAX_TASKS];
+    uint32_t coReleased[SCHED_MAX_TASKS];   // Bit mask of the placed tasks which are released at the same tick at least once
+    uint32_t placedMask = 0;
+
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        SchedulerTask* pTask = &(pScheduler->tasks[i]);
+
+        load[i] = 1;
+        if (pTask->stats.runCount > 0 && pTask->stats.execCyclesMax > 0)
+            load[i] = pTask->stats.execCyclesMax;
+
+        coReleased[i] = 0;
+    }
+
+    for (int32_t n = 0; n < taskCount; n++)
+    {
+        // Select the next task: shortest period first, the highest load on equal periods
+        int32_t next = -1;
+        for (int32_t i = 0; i < taskCount; i++)
+        {
+            if ((placedMask & (1UL << i)) != 0)
+                continue;
+
+            if (next < 0 || pScheduler->tasks[i].period < pScheduler->tasks[next].period
+                || (pScheduler->tasks[i].period == pScheduler->tasks[next].period && load[i] > load[next]))
+            {
+                next = i;
+            }
+        }
+
+        SchedulerTask* pTask = &(pScheduler->tasks[next]);
+
+        // Two tasks are released at the same tick at least once, if their
+        // phases are equal modulo the GCD of their periods. So only the
+        // phases up to the LCM of these GCDs have to be checked.
+        uint32_t phaseRange = 1;
+        for (int32_t i = 0; i < taskCount; i++)
+        {
+            if ((placedMask & (1UL << i)) != 0)
+            {
+                uint32_t gcd = schedGCD(pTask->period, pScheduler->tasks[i].period);
+                phaseRange = phaseRange / schedGCD(phaseRange, gcd) * gcd;
+            }
+        }
+
+        uint32_t bestPhase = 0;
+        uint32_t bestMask = 0;
+        uint64_t bestPeak = UINT64_MAX;
+        uint32_t bestCount = UINT32_MAX;
+
+        for (uint32_t phase = 0; phase < phaseRange; phase++)
+        {
+            uint32_t mask = 0;
+            uint32_t count = 0;
+
+            for (int32_t i = 0; i < taskCount; i++)
+            {
+                if ((placedMask & (1UL << i)) == 0)
+                    continue;
+
+                uint32_t gcd = schedGCD(pTask->period, pScheduler->tasks[i].period);
+                if ((phase % gcd) == (pScheduler->tasks[i].phase % gcd))
+                {
+                    mask |= (1UL << i);
+                    count++;
+                }
+            }
+
+            // The peak is the highest load of all task sets which can be released together
+            uint64_t peak = load[next] + schedMaxReleaseLoad(load, coReleased, mask);
+
+            if (peak < bestPeak || (peak == bestPeak && count < bestCount))
+            {
+                bestPhase   = phase;
+                bestMask    = mask;
+                bestPeak    = peak;
+                bestCount   = count;
+            }
+        }
+
+        pTask->phase = bestPhase;
+        coReleased[next] = bestMask;
+        for (int32_t i = 0; i < taskCount; i++)
+        {
+            if ((bestMask & (1UL << i)) != 0)
+                coReleased[i] |= (1UL << next);
+        }
+
+        placedMask |= (1UL << next);
+    }
+
+    // Restart all tasks with their new phase
+    uint32_t halTick = pScheduler->pGetHALTick();
+
+    pScheduler->pDueList = 0;
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        pScheduler->tasks[i].nextRelease = halTick + pScheduler->tasks[i].phase;
+        schedInsertDueList(pScheduler, &(pScheduler->tasks[i]));
+    }
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedSetFrameTable(Scheduler* pScheduler, const SchedulerFrameTable* pFrameTable)
+{
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0 || pFrameTable == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (pFrameTable->pTasks == 0 || pFrameTable->pFrameStart == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (pFrameTable->minorFrame == 0 || pFrameTable->frameCount == 0)
+        return SCHED_ERR_INVALID_PARAM;
+
+    pScheduler->pFrameTable         = pFrameTable;
+    pScheduler->frameIndex          = 0;
+    pScheduler->nextFrame           = pScheduler->pGetHALTick();
+    pScheduler->frameOverrunCount   = 0;
 
     return SCHED_ERR_OK;
 }
@@ -51,10 +275,397 @@ int32_t schedInitialize(Scheduler* pScheduler)
 
 int32_t schedCycle(Scheduler* pScheduler)
 {
+    if (pScheduler == 0 || pScheduler->pGetHALTick == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (pScheduler->workQueueCount > 0)
+        schedRunDeferredWork(pScheduler);
+
+    if (pScheduler->pFrameTable != 0)
+    {
+        schedRunFrame(pScheduler);
+        return SCHED_ERR_OK;
+    }
+
+    SchedulerTask* pTask = pScheduler->pDueList;
+
+    // Fast path: nothing registered or the earliest task is not due yet
+    if (pTask == 0)
+        return SCHED_ERR_OK;
+
+    uint32_t halTick = pScheduler->pGetHALTick();
+
+    while (pTask != 0 && !SCHED_TICK_BEFORE(halTick, pTask->nextRelease))
+    {
+        uint32_t releaseTick = pTask->nextRelease;
+        uint32_t startTick = pScheduler->pGetHALTick();
+
+        // Remove the task from the head of the list and put it back
+        // according its next release before executing it
+        pScheduler->pDueList = pTask->pNext;
+        pTask->nextRelease = schedCalcNextRelease(pTask, releaseTick, startTick);
+        schedInsertDueList(pScheduler, pTask);
+
+        uint32_t startCycles = 0;
+        if (pScheduler->pGetCycleCount != 0)
+            startCycles = pScheduler->pGetCycleCount();
+
+        pTask->pTask();
+
+        uint32_t execCycles = 0;
+        if (pScheduler->pGetCycleCount != 0)
+            execCycles = pScheduler->pGetCycleCount() - startCycles;
+
+        // The task overran if its next release became due while it was running
+        uint32_t endTick = pScheduler->pGetHALTick();
+        bool overrun = SCHED_TICK_BEFORE(startTick, pTask->nextRelease)
+                    && !SCHED_TICK_BEFORE(endTick, pTask->nextRelease);
+
+        schedUpdateTaskStats(pTask, execCycles, startTick - releaseTick, overrun);
+
+        pTask = pScheduler->pDueList;
+    }
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedAddWorkQueue(Scheduler* pScheduler, WorkQueue* pQueue)
+{
+    if (pScheduler == 0 || pQueue == 0)
+        return SCHED_ERR_INVALID_PTR;
 
+    if (pScheduler->workQueueCount >= SCHED_MAX_WORK_QUEUES)
+        return SCHED_ERR_TABLE_FULL;
+
+    pScheduler->pWorkQueues[pScheduler->workQueueCount] = pQueue;
+    pScheduler->workQueueCount++;
+
+    return SCHED_ERR_OK;
+}
+
+
+bool schedHasPendingWork(Scheduler* pScheduler)
+{
+    if (pScheduler == 0)
+        return false;
+
+    for (int32_t i = 0; i < pScheduler->workQueueCount; i++)
+    {
+        if (workqIsPending(pScheduler->pWorkQueues[i]) == true)
+            return true;
+    }
+
+    return false;
+}
+
+
+int32_t schedGetNextRelease(Scheduler* pScheduler, uint32_t* pReleaseTick)
+{
+    if (pScheduler == 0 || pReleaseTick == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (pScheduler->pFrameTable != 0)
+    {
+        *pReleaseTick = pScheduler->nextFrame;
+        return SCHED_ERR_OK;
+    }
+
+    if (pScheduler->pDueList == 0)
+        return SCHED_ERR_NO_TASK;
+
+    *pReleaseTick = pScheduler->pDueList->nextRelease;
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedGetTaskStats(Scheduler* pScheduler, int32_t taskID, SchedulerTaskStats* pStats)
+{
+    if (pScheduler == 0 || pStats == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    if (taskID < 0 || taskID >= pScheduler->taskCount)
+        return SCHED_ERR_INVALID_PARAM;
+
+    SchedulerTask* pTask = &(pScheduler->tasks[taskID]);
+
+    *pStats = pTask->stats;
+
+    // The averages are only calculated here to keep the division out of schedCycle()
+    if (pStats->runCount > 0)
+    {
+        pStats->execCyclesAvg   = (uint32_t)(pTask->execCyclesSum / pStats->runCount);
+        pStats->jitterAvg       = (uint32_t)(pTask->jitterSum / pStats->runCount);
+    }
+    else
+    {
+        pStats->execCyclesMin   = 0;
+        pStats->jitterMin       = 0;
+    }
+
+    return SCHED_ERR_OK;
+}
+
+
+int32_t schedResetTaskStats(Scheduler* pScheduler)
+{
+    if (pScheduler == 0)
+        return SCHED_ERR_INVALID_PTR;
+
+    for (int32_t i = 0; i < pScheduler->taskCount; i++)
+    {
+        schedClearTaskStats(&(pScheduler->tasks[i]));
+    }
 
     return SCHED_ERR_OK;
 }
 
 
 /***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Inserts a task into the list of tasks sorted by the next release
+ *
+ * Tasks with the same release time are sorted by their period, so that
+ * the task with the shortest period is executed first.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param pTask         Task to insert (must not be part of the list)
+ */
+static void schedInsertDueList(Scheduler* pScheduler, SchedulerTask* pTask)
+{
+    SchedulerTask** ppLink = &(pScheduler->pDueList);
+
+    while (*ppLink != 0)
+    {
+        SchedulerTask* pCurrent = *ppLink;
+
+        if (SCHED_TICK_BEFORE(pTask->nextRelease, pCurrent->nextRelease))
+            break;
+
+        if (pTask->nextRelease == pCurrent->nextRelease && pTask->period < pCurrent->period)
+            break;
+
+        ppLink = &(pCurrent->pNext);
+    }
+
+    pTask->pNext = *ppLink;
+    *ppLink = pTask;
+}
+
+/**
+ * @brief Calculates the next release of a task which is started now
+ *
+ * If the next regular release is already due, the policy of the task
+ * decides how the missed releases are handled. The division is only
+ * needed in this case.
+ *
+ * @param pTask         Task which is started
+ * @param releaseTick   Release tick of the current execution
+ * @param halTick       Current HAL tick (start of the execution)
+ *
+ * @return HAL tick of the next release
+ */
+static uint32_t schedCalcNextRelease(SchedulerTask* pTask, uint32_t releaseTick, uint32_t halTick)
+{
+    uint32_t nextRelease = releaseTick + pTask->period;
+
+    // Regular case: next release is still in the future
+    if (SCHED_TICK_BEFORE(halTick, nextRelease))
+        return nextRelease;
+
+    // Number of releases between the current release and now (at least one)
+    uint32_t missed = (halTick - releaseTick) / pTask->period;
+    uint32_t skipped = 0;
+
+    switch (pTask->policy)
+    {
+        case SCHED_POLICY_REPHASE:
+            skipped     = missed;
+            nextRelease = halTick + pTask->period;
+            break;
+
+        case SCHED_POLICY_CATCH_UP:
+            // The missed releases stay due and are executed by the next
+            // iterations of schedCycle(), only the rest is skipped
+            if (missed > pTask->maxCatchUp)
+                skipped = missed - pTask->maxCatchUp;
+
+            nextRelease = releaseTick + (skipped + 1) * pTask->period;
+            break;
+
+        case SCHED_POLICY_SKIP:
+        default:
+            skipped     = missed;
+            nextRelease = releaseTick + (missed + 1) * pTask->period;
+            break;
+    }
+
+    pTask->stats.missedCount++;
+    pTask->stats.skippedCount += skipped;
+
+    return nextRelease;
+}
+
+/**
+ * @brief Executes pending deferred work within the work budget
+ *
+ * The queues are processed in order of their priority, a lower priority
+ * queue only gets the budget which is left by the higher priority queues.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ */
+static void schedRunDeferredWork(Scheduler* pScheduler)
+{
+    uint32_t budget = pScheduler->workBudget;
+
+    for (int32_t i = 0; i < pScheduler->workQueueCount && budget > 0; i++)
+    {
+        budget -= workqRun(pScheduler->pWorkQueues[i], budget);
+    }
+}
+
+/**
+ * @brief Executes the tasks of the current minor frame, if it has started
+ *
+ * The frame index is advanced without division, the start of the next
+ * frame is always calculated from the ideal start of the current frame.
+ *
+ * @param pScheduler    Pointer to scheduler struct (with frame table)
+ */
+static void schedRunFrame(Scheduler* pScheduler)
+{
+    const SchedulerFrameTable* pFrameTable = pScheduler->pFrameTable;
+
+    // Fast path: the next frame has not started yet
+    if (SCHED_TICK_BEFORE(pScheduler->pGetHALTick(), pScheduler->nextFrame))
+        return;
+
+    uint32_t frame = pScheduler->frameIndex;
+
+    for (uint32_t i = pFrameTable->pFrameStart[frame]; i < pFrameTable->pFrameStart[frame + 1]; i++)
+    {
+        pFrameTable->pTasks[i]();
+    }
+
+    frame++;
+    if (frame >= pFrameTable->frameCount)
+        frame = 0;
+
+    pScheduler->frameIndex  = frame;
+    pScheduler->nextFrame  += pFrameTable->minorFrame;
+
+    // The frame overran if the following frame is already due
+    if (!SCHED_TICK_BEFORE(pScheduler->pGetHALTick(), pScheduler->nextFrame))
+        pScheduler->frameOverrunCount++;
+}
+
+/**
+ * @brief Calculates the greatest common divisor of two values
+ *
+ * @param a             First value
+ * @param b             Second value
+ *
+ * @return GCD of a and b
+ */
+static uint32_t schedGCD(uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {
+        uint32_t rest = a % b;
+        a = b;
+        b = rest;
+    }
+
+    return a;
+}
+
+/**
+ * @brief Calculates the highest load of a set of tasks which are released
+ * at the same tick
+ *
+ * Following the chinese remainder theorem, a set of tasks is released
+ * together at some tick if each pair of them is. So this is the maximum
+ * weight clique of the candidates, which is found by a simple recursive
+ * search (the number of tasks is small).
+ *
+ * @param pLoad         Load of each task
+ * @param pCoReleased   Bit mask of the tasks which are released together with each task
+ * @param candidates    Bit mask of the tasks which can be part of the set
+ *
+ * @return Highest load of any set
+ */
+static uint64_t schedMaxReleaseLoad(const uint32_t* pLoad, const uint32_t* pCoReleased, uint32_t candidates)
+{
+    uint64_t maxLoad = 0;
+
+    for (int32_t i = 0; i < SCHED_MAX_TASKS && candidates != 0; i++)
+    {
+        if ((candidates & (1UL << i)) == 0)
+            continue;
+
+        candidates &= ~(1UL << i);
+
+        uint64_t load = pLoad[i] + schedMaxReleaseLoad(pLoad, pCoReleased, candidates & pCoReleased[i]);
+        if (load > maxLoad)
+            maxLoad = load;
+    }
+
+    return maxLoad;
+}
+
+/**
+ * @brief Resets the runtime statistics of a task
+ *
+ * @param pTask         Task to reset the statistics for
+ */
+static void schedClearTaskStats(SchedulerTask* pTask)
+{
+    pTask->stats.runCount       = 0;
+    pTask->stats.overrunCount   = 0;
+    pTask->stats.missedCount    = 0;
+    pTask->stats.skippedCount   = 0;
+    pTask->stats.execCyclesMin  = UINT32_MAX;
+    pTask->stats.execCyclesMax  = 0;
+    pTask->stats.execCyclesAvg  = 0;
+    pTask->stats.jitterMin      = UINT32_MAX;
+    pTask->stats.jitterMax      = 0;
+    pTask->stats.jitterAvg      = 0;
+
+    pTask->execCyclesSum        = 0;
+    pTask->jitterSum            = 0;
+}
+
+/**
+ * @brief Updates the runtime statistics of a task after its execution
+ *
+ * @param pTask         Task which has been executed
+ * @param execCycles    Execution time in cycles
+ * @param jitter        Delay between ideal and actual release in HAL ticks
+ * @param overrun       Flag whether the task exceeded its next release
+ */
+static void schedUpdateTaskStats(SchedulerTask* pTask, uint32_t execCycles, uint32_t jitter, bool overrun)
+{
+    SchedulerTaskStats* pStats = &(pTask->stats);
+
+    pStats->runCount++;
+
+    if (overrun == true)
+        pStats->overrunCount++;
+
+    if (execCycles < pStats->execCyclesMin)
+        pStats->execCyclesMin = execCycles;
+
+    if (execCycles > pStats->execCyclesMax)
+        pStats->execCyclesMax = execCycles;
+
+    if (jitter < pStats->jitterMin)
+        pStats->jitterMin = jitter;
+
+    if (jitter > pStats->jitterMax)
+        pStats->jitterMax = jitter;
+
+    pTask->execCyclesSum    += execCycles;
+    pTask->jitterSum        += jitter;
+}
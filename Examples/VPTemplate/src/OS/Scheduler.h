@@ -10,6 +10,21 @@
  *
  * @brief Header File for cooperative scheduler module
  *
+ * @details The scheduler manages a table of cyclic tasks with an arbitrary
+ * period and phase (both in HAL ticks). All registered tasks are kept in a
+ * list which is sorted by the next release time, so the check whether any
+ * task is due is a single compare against the head of this list.
+ *
+ * As alternative for hard real-time builds, a static frame table (cyclic
+ * executive) can be set. The table is generated offline from the task list
+ * by Scripts/gen_cyclic_schedule.py and holds the tasks of every minor frame
+ * of the hyperperiod. schedCycle() then only executes the tasks of the
+ * current frame, no scheduling decision is made at runtime.
+ *
+ * All time stamps are compared by their signed difference, so the scheduler
+ * keeps working across the wrap around of the 32bit HAL tick (after approx.
+ * 49 days). This requires that no task is delayed by more than 2^31 ticks.
+ *
  *
  *****************************************************************************/
 #ifndef _SCHEDULER_H_
@@ -17,14 +32,30 @@
 
 
 /***** INCLUDES **************************************************************/
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "WorkQueue.h"
+
 /***** CONSTANTS *************************************************************/
 
 
 /***** MACROS ****************************************************************/
 #define SCHED_ERR_OK                0           //!< No error occured (Scheduler)
 #define SCHED_ERR_INVALID_PTR       -1          //!< Invalid pointer (Scheduler)
+#define SCHED_ERR_INVALID_PARAM     -2          //!< Invalid parameter value (Scheduler)
+#define SCHED_ERR_TABLE_FULL        -3          //!< No free entry left in the task table (Scheduler)
+#define SCHED_ERR_NO_TASK           -4          //!< No task registered (Scheduler)
+
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS             8           //!< Maximum number of tasks which can be registered
+#endif
+
+#ifndef SCHED_MAX_WORK_QUEUES
+#define SCHED_MAX_WORK_QUEUES       4           //!< Maximum number of deferred work queues
+#endif
+
+#define SCHED_DEFAULT_WORK_BUDGET   8           //!< Default number of work items executed per schedCycle() call
 
 /***** TYPES *****************************************************************/
 
@@ -38,6 +69,15 @@
  */
 typedef uint32_t (*GetHALTick)(void);
 
+/**
+ * @brief Function pointer for reading a free running cycle counter
+ *
+ * On the target this is the DWT cycle counter of the Cortex-M4. The
+ * pointer is optional, if it is not set no execution times are measured.
+ *
+ */
+typedef uint32_t (*GetCycleCount)(void);
+
 /**
  * @brief Function pointer for cyclic function for the scheduler
  *
@@ -45,28 +85,109 @@ typedef uint32_t (*GetHALTick)(void);
 typedef void (*CyclicFunction)(void);
 
 /**
- * @brief Struct definition which holds the HAL tick
- * time stamps for the different tasks
+ * @brief Policy of a task for releases which have been missed
+ *
+ * A release is missed, if a task starts later than its next release (e.g.
+ * because another task blocked the CPU).
+ *
+ */
+typedef enum _SchedulerPolicy
+{
+    SCHED_POLICY_SKIP,                  //!< Run once and skip the missed releases, the task stays on its time grid
+    SCHED_POLICY_REPHASE,               //!< Run once and restart the period from the actual start time
+    SCHED_POLICY_CATCH_UP               //!< Run again for up to maxCatchUp missed releases, skip the rest
+} SchedulerPolicy;
+
+/**
+ * @brief Runtime statistics of a single task
+ *
+ * Execution times are measured in cycles of the cycle counter, the release
+ * jitter is the delay between the ideal release tick and the actual start of
+ * the task in HAL ticks. An overrun is counted whenever a task is still
+ * running when its next release is already due.
+ *
+ * missedCount counts executions, not stalls: with SCHED_POLICY_SKIP and
+ * SCHED_POLICY_REPHASE a stall adds one, with SCHED_POLICY_CATCH_UP every
+ * catch-up execution which still starts after its following release adds
+ * one (min(missed releases, maxCatchUp) per stall, at least one).
+ *
+ */
+typedef struct _SchedulerTaskStats
+{
+    uint32_t runCount;                  //!< Number of executions of the task
+    uint32_t overrunCount;              //!< Number of executions which exceeded the next release
+    uint32_t missedCount;               //!< Number of executions which started after missing a release (policy applied)
+    uint32_t skippedCount;              //!< Number of releases which have been dropped by the policy
+
+    uint32_t execCyclesMin;             //!< Minimum execution time in cycles
+    uint32_t execCyclesMax;             //!< Maximum execution time in cycles
+    uint32_t execCyclesAvg;             //!< Average execution time in cycles
+
+    uint32_t jitterMin;                 //!< Minimum release jitter in HAL ticks
+    uint32_t jitterMax;                 //!< Maximum release jitter in HAL ticks
+    uint32_t jitterAvg;                 //!< Average release jitter in HAL ticks
+} SchedulerTaskStats;
+
+/**
+ * @brief Struct which represents one entry of the scheduler task table
+ *
+ */
+typedef struct _SchedulerTask
+{
+    CyclicFunction pTask;               //!< Function pointer to the cyclic task function
+    uint32_t period;                    //!< Period of the task in HAL ticks
+    uint32_t phase;                     //!< Phase offset of the first release in HAL ticks
+    uint32_t nextRelease;               //!< HAL tick of the next release of the task
+
+    SchedulerPolicy policy;             //!< Policy for missed releases
+    uint32_t maxCatchUp;                //!< Maximum number of missed releases which are executed (SCHED_POLICY_CATCH_UP)
+
+    struct _SchedulerTask* pNext;       //!< Next task in the list sorted by release time
+
+    SchedulerTaskStats stats;           //!< Runtime statistics (average values are only updated on read)
+    uint64_t execCyclesSum;             //!< Sum of all execution times used for the average
+    uint64_t jitterSum;                 //!< Sum of all release jitters used for the average
+} SchedulerTask;
+
+/**
+ * @brief Static schedule of a cyclic executive
+ *
+ * The tasks of frame n are pTasks[pFrameStart[n]] up to (excluding)
+ * pTasks[pFrameStart[n + 1]]. The table is intended to be placed in flash
+ * (const) and is normally generated by Scripts/gen_cyclic_schedule.py.
+ *
+ */
+typedef struct _SchedulerFrameTable
+{
+    uint32_t minorFrame;                //!< Length of a minor frame in HAL ticks
+    uint32_t frameCount;                //!< Number of minor frames per hyperperiod
+    const CyclicFunction* pTasks;       //!< Tasks of all frames in order of execution
+    const uint16_t* pFrameStart;        //!< Index of the first task of each frame in pTasks (frameCount + 1 entries)
+} SchedulerFrameTable;
+
+/**
+ * @brief Struct definition which holds the task table and the
+ * list of tasks sorted by their next release time
  *
  */
 typedef struct _Scheduler
 {
     GetHALTick pGetHALTick;             //!< Function pointer for callback to read current HAL tick counter
+    GetCycleCount pGetCycleCount;       //!< Optional function pointer to read a cycle counter for runtime measurement
 
-    uint32_t halTick_1ms;               //!< Timestamp for last execution of 1ms task
-    CyclicFunction pTask_1ms;           //!< Function pointer to 1ms cyclic task function
+    int32_t taskCount;                  //!< Number of registered tasks
+    SchedulerTask tasks[SCHED_MAX_TASKS];   //!< Task table
 
-    uint32_t halTick_10ms;              //!< Timestamp for last execution of 10ms task
-    CyclicFunction pTask_10ms;          //!< Function pointer to 10ms cyclic task function
+    SchedulerTask* pDueList;            //!< Head of the task list sorted by next release (earliest first)
 
-    uint32_t halTick_100ms;             //!< Timestamp for last execution of 100ms task
-    CyclicFunction pTask_100ms;         //!< Function pointer to 100ms cyclic task function
+    int32_t workQueueCount;             //!< Number of attached work queues
+    WorkQueue* pWorkQueues[SCHED_MAX_WORK_QUEUES];  //!< Deferred work queues (index 0 = highest priority)
+    uint32_t workBudget;                //!< Maximum number of work items executed per schedCycle() call
 
-    uint32_t halTick_250ms;             //!< Timestamp for last execution of 250ms task
-    CyclicFunction pTask_250ms;         //!< Function pointer to 250ms cyclic task function
-
-    uint32_t halTick_1000ms;            //!< Timestamp for last execution of 1000ms task
-    CyclicFunction pTask_1000ms;        //!< Function pointer to 1000ms cyclic task function
+    const SchedulerFrameTable* pFrameTable; //!< Static schedule (0 = dynamic scheduling with the task table)
+    uint32_t frameIndex;                //!< Index of the next minor frame
+    uint32_t nextFrame;                 //!< HAL tick of the start of the next minor frame
+    uint32_t frameOverrunCount;         //!< Number of minor frames which exceeded the start of the following frame
 } Scheduler;
 
 
@@ -75,10 +196,11 @@ typedef struct _Scheduler
 
 /**
  * @brief Initializes the Scheduler component
- * Initializes the internal values for the timestamps.
+ * Clears the task table and the list of due tasks.
  *
- * @remark: This function doesn't initialize the function
- * pointers in the Scheduler struct!
+ * @remark: The function pointers pGetHALTick and pGetCycleCount must
+ * be set before this function is called. They are not changed by this
+ * function. The work budget is set to SCHED_DEFAULT_WORK_BUDGET.
  *
  * @param pScheduler Pointer to scheduler struct
  *
@@ -86,16 +208,150 @@ typedef struct _Scheduler
  */
 int32_t schedInitialize(Scheduler* pScheduler);
 
+/**
+ * @brief Registers a cyclic task at the scheduler
+ *
+ * The first release of the task is at "current HAL tick + phase", all
+ * further releases follow with the given period. Tasks which are due at
+ * the same tick are executed in order of their period (shortest first).
+ * Missed releases are handled with SCHED_POLICY_SKIP.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param pTask         Cyclic function which should be called
+ * @param period        Period of the task in HAL ticks (must be > 0)
+ * @param phase         Offset of the first release in HAL ticks
+ *
+ * @return The ID (index in the task table) of the new task or a
+ * negative SCHED_ERR_* code in case of an error
+ */
+int32_t schedAddTask(Scheduler* pScheduler, CyclicFunction pTask, uint32_t period, uint32_t phase);
+
+/**
+ * @brief Sets the policy of a task for missed releases
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param taskID        ID of the task as returned by schedAddTask()
+ * @param policy        Policy for missed releases
+ * @param maxCatchUp    Maximum number of missed releases which are executed
+ *                      back to back (only used for SCHED_POLICY_CATCH_UP)
+ *
+ * @return SCHED_ERR_OK if no error occured
+ */
+int32_t schedSetTaskPolicy(Scheduler* pScheduler, int32_t taskID, SchedulerPolicy policy, uint32_t maxCatchUp);
+
+/**
+ * @brief Assigns new phase offsets to all tasks to spread their load
+ *
+ * The offsets are chosen in order of the task period (shortest first), so
+ * that the peak load of all tasks which are released at the same tick is
+ * minimal. The load of a task is its measured maximum execution time, so
+ * the tasks should have been running for a while before. Tasks without
+ * measurement (or without cycle counter) count with the same load.
+ *
+ * All tasks are restarted with their new phase relative to the current
+ * HAL tick. The function must not be called from a task.
+ *
+ * @remark: The search is done once at runtime and is not optimized for
+ * speed, it takes up to (max. period * 2^taskCount) steps.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ *
+ * @return SCHED_ERR_OK if no error occured, SCHED_ERR_NO_TASK if no
+ * task is registered
+ */
+int32_t schedSpreadPhases(Scheduler* pScheduler);
+
+/**
+ * @brief Switches the scheduler to the static schedule of a cyclic executive
+ *
+ * The first minor frame starts with the current HAL tick. Tasks which
+ * have been added with schedAddTask() are no longer executed.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param pFrameTable   Static frame table (must stay valid)
+ *
+ * @return SCHED_ERR_OK if no error occured
+ */
+int32_t schedSetFrameTable(Scheduler* pScheduler, const SchedulerFrameTable* pFrameTable);
+
 /**
  * @brief Cyclic function for the scheduler
  * This function should be called in the super loop of the system
  * Hereby the scheduler takes care of the different time slots for
  * the tasks
  *
+ * Before the tasks are checked, pending deferred work is executed
+ * (at most workBudget items per call, in order of the queue priority).
+ *
+ * If no task is due, the function returns after a single compare of
+ * the current HAL tick against the earliest release time.
+ *
+ * With a frame table set, the tasks of the current minor frame are
+ * executed in table order as soon as the frame has started. Frames which
+ * are delayed (e.g. by an overrun) are executed back to back, so the
+ * schedule keeps its time grid.
+ *
  * @param pScheduler Pointer to scheduler struct
  *
  * @return SCHED_ERR_OK if no error occured
  */
 int32_t schedCycle(Scheduler* pScheduler);
 
+/**
+ * @brief Attaches a deferred work queue to the scheduler
+ *
+ * The queues are drained in the order they have been attached, so
+ * the first queue has the highest priority.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param pQueue        Initialized work queue
+ *
+ * @return SCHED_ERR_OK if no error occured
+ */
+int32_t schedAddWorkQueue(Scheduler* pScheduler, WorkQueue* pQueue);
+
+/**
+ * @brief Checks whether deferred work is pending in any attached queue
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ *
+ * @return true if work is pending
+ */
+bool schedHasPendingWork(Scheduler* pScheduler);
+
+/**
+ * @brief Returns the HAL tick of the next task release
+ *
+ * This can be used to sleep until the next task is due. The returned
+ * tick can already be in the past. With a frame table set, this is the
+ * start of the next minor frame.
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param pReleaseTick  Pointer to store the HAL tick of the next release
+ *
+ * @return SCHED_ERR_OK if no error occured, SCHED_ERR_NO_TASK if no
+ * task is registered
+ */
+int32_t schedGetNextRelease(Scheduler* pScheduler, uint32_t* pReleaseTick);
+
+/**
+ * @brief Reads the runtime statistics of a task
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ * @param taskID        ID of the task as returned by schedAddTask()
+ * @param pStats        Pointer to store the statistics
+ *
+ * @return SCHED_ERR_OK if no error occured
+ */
+int32_t schedGetTaskStats(Scheduler* pScheduler, int32_t taskID, SchedulerTaskStats* pStats);
+
+/**
+ * @brief Resets the runtime statistics of all tasks
+ *
+ * @param pScheduler    Pointer to scheduler struct
+ *
+ * @return SCHED_ERR_OK if no error occured
+ */
+int32_t schedResetTaskStats(Scheduler* pScheduler);
+
 #endif
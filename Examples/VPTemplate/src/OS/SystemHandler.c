@@ -17,6 +17,10 @@
 /***** INCLUDES **************************************************************/
 #include "stm32g4xx_hal.h"
 
+#ifdef OS_KERNEL_PREEMPTIVE
+#include "Kernel.h"
+#endif
+
 /***** PRIVATE CONSTANTS *****************************************************/
 
 
@@ -59,9 +63,15 @@ void NMI_Handler(void)
  * instruction. In an OS environment, applications can use SVC
  * instructions to access OS kernel functions and device drivers.
  *
+ * With the preemptive kernel, the SVC is used by the tasks to signal
+ * the end of their cyclic function.
+ *
  */
 void SVC_Handler(void)
 {
+#ifdef OS_KERNEL_PREEMPTIVE
+    kernelHandleSVC();
+#endif
 }
 
 /**
@@ -72,17 +82,27 @@ void SVC_Handler(void)
  * OS environment, use PendSV for context switching when no other
  * exception is active.
  *
+ * With the preemptive kernel, the handler branches directly into the
+ * context switch, so no additional stack frame is created.
+ *
  */
+#ifdef OS_KERNEL_PREEMPTIVE
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __ASM volatile ("b kernelPendSV");
+}
+#else
 void PendSV_Handler(void)
 {
 }
+#endif
 
 /**
  * @brief Default-Implementation of SysTick Handler
  *
  * This handler is called for every "tick" of the SysTick
- * timer. Currently, only the internal Tick-Counter for
- * the HAL is updated
+ * timer. The internal Tick-Counter for the HAL is updated
+ * and, with the preemptive kernel, the due tasks are released
  *
  * According Programming Manual:
  * A SysTick exception is an exception the system timer generates
@@ -94,6 +114,10 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
   HAL_IncTick();
+
+#ifdef OS_KERNEL_PREEMPTIVE
+  kernelTick();
+#endif
 }
 
 /**
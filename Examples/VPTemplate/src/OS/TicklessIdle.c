@@ -0,0 +1,185 @@
+/******************************************************************************
+ * @file TicklessIdle.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the tickless idle mode
+ *
+ * @details The sleep time is programmed into the SysTick reload register, so
+ * the SysTick interrupt only occurs at the end of the sleep time. The
+ * interrupts are disabled (PRIMASK) while sleeping. A pending interrupt still
+ * wakes up the core, but it is only executed after the SysTick and the HAL
+ * tick have been corrected.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "stm32g4xx_hal.h"
+
+#include "TicklessIdle.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define IDLE_SYSTICK_MAX_COUNT      0x01000000UL    //!< Number of counts of the 24bit SysTick counter
+#define IDLE_MIN_RELOAD_CYCLES      16              //!< Minimum number of cycles to program into the SysTick
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static void idleRestartSysTick(uint32_t cyclesToNextTick);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static uint32_t gCyclesPerTick = 0;         //!< Number of SysTick cycles for one HAL tick
+static uint32_t gMaxSleepTicks = 0;         //!< Maximum number of ticks which fit into the SysTick counter
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t idleInitialize(void)
+{
+    gCyclesPerTick = SysTick->LOAD + 1;
+    gMaxSleepTicks = IDLE_SYSTICK_MAX_COUNT / gCyclesPerTick;
+
+    // Use sleep mode, the peripherals have to keep running
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+    return IDLE_ERR_OK;
+}
+
+
+int32_t idleSleepUntil(uint32_t wakeTick)
+{
+    if (gCyclesPerTick == 0)
+        return IDLE_ERR_NOT_INITIALIZED;
+
+    // Keep the interrupt state of the caller, so the caller can make a check
+    // before calling this function atomic
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    int32_t sleepTicks = (int32_t)(wakeTick - HAL_GetTick());
+
+    if (sleepTicks <= 0)
+    {
+        __set_PRIMASK(primask);
+        return IDLE_ERR_OK;
+    }
+
+    // The next regular SysTick wakes up the core anyway
+    if (sleepTicks == 1)
+    {
+        __DSB();
+        __WFI();
+        __ISB();
+
+        __set_PRIMASK(primask);
+        return IDLE_ERR_OK;
+    }
+
+    if ((uint32_t)sleepTicks > gMaxSleepTicks)
+        sleepTicks = gMaxSleepTicks;
+
+    // Stop the SysTick and check whether a tick occured in the meantime
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+    {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        __set_PRIMASK(primask);
+        return IDLE_ERR_OK;
+    }
+
+    // Cycles until the end of the current tick (a value of 0 means the counter is just reloading)
+    uint32_t currentCycles = SysTick->VAL;
+    if (currentCycles == 0)
+        currentCycles = gCyclesPerTick;
+
+    // Program the complete sleep time into the SysTick
+    uint32_t reloadValue = currentCycles + ((uint32_t)sleepTicks - 1) * gCyclesPerTick - 1;
+    SysTick->LOAD   = reloadValue;
+    SysTick->VAL    = 0;
+    SysTick->CTRL  |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    // Reading CTRL clears the COUNTFLAG, so it is only read once
+    uint32_t ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    uint32_t elapsedCycles = reloadValue - SysTick->VAL;
+    uint32_t skippedTicks = 0;
+    uint32_t cyclesToNextTick = 0;
+
+    if ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) != 0)
+    {
+        // The complete sleep time elapsed. The pending SysTick interrupt counts
+        // the last tick, the counter has already been reloaded and continued
+        skippedTicks = (uint32_t)sleepTicks - 1;
+
+        if (elapsedCycles < gCyclesPerTick)
+            cyclesToNextTick = gCyclesPerTick - elapsedCycles;
+    }
+    else
+    {
+        // Woken up by another interrupt, count the ticks which have elapsed
+        // since the last regular tick
+        uint32_t cyclesSinceTick = elapsedCycles + (gCyclesPerTick - currentCycles);
+
+        skippedTicks        = cyclesSinceTick / gCyclesPerTick;
+        cyclesToNextTick    = gCyclesPerTick - (cyclesSinceTick % gCyclesPerTick);
+    }
+
+    // Too close to the next tick, count it now and continue with a full tick
+    if (cyclesToNextTick < IDLE_MIN_RELOAD_CYCLES)
+    {
+        skippedTicks++;
+        cyclesToNextTick += gCyclesPerTick;
+    }
+
+    idleRestartSysTick(cyclesToNextTick);
+
+    for (uint32_t i = 0; i < skippedTicks; i++)
+    {
+        HAL_IncTick();
+    }
+
+    __set_PRIMASK(primask);
+
+    return IDLE_ERR_OK;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Restarts the SysTick with the regular tick period
+ *
+ * The first SysTick interrupt occurs after the given number of cycles,
+ * all following interrupts with the regular period.
+ *
+ * @param cyclesToNextTick  Cycles until the next SysTick interrupt
+ */
+static void idleRestartSysTick(uint32_t cyclesToNextTick)
+{
+    SysTick->LOAD   = cyclesToNextTick - 1;
+    SysTick->VAL    = 0;
+    SysTick->CTRL  |= SysTick_CTRL_ENABLE_Msk;
+
+    // The new reload value is only used after the next underflow
+    SysTick->LOAD   = gCyclesPerTick - 1;
+}
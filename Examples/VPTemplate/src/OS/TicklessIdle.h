@@ -0,0 +1,73 @@
+/******************************************************************************
+ * @file TicklessIdle.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File for the tickless idle mode
+ *
+ * @details Puts the core into sleep mode until a given HAL tick. The SysTick
+ * is reprogrammed to the full sleep time, so the core isn't woken up every
+ * millisecond. After the wakeup the HAL tick is corrected by the number of
+ * skipped ticks. Other interrupts (e.g. ADC DMA) still wake up the core
+ * earlier, in this case only the elapsed ticks are added.
+ *
+ * Stop mode isn't used, because TIM3, ADC and DMA have to keep running
+ * during idle. The tickless idle mode must not be used together with the
+ * preemptive kernel, which needs every SysTick.
+ *
+ *
+ *****************************************************************************/
+#ifndef _TICKLESS_IDLE_H_
+#define _TICKLESS_IDLE_H_
+
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define IDLE_ERR_OK                 0           //!< No error occured (Idle)
+#define IDLE_ERR_NOT_INITIALIZED    -1          //!< idleInitialize() hasn't been called (Idle)
+
+
+/***** TYPES *****************************************************************/
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes the tickless idle mode
+ *
+ * Reads the SysTick configuration, so it must be called after HAL_Init()
+ * and SystemClock_Config().
+ *
+ * @return IDLE_ERR_OK if no error occured
+ */
+int32_t idleInitialize(void);
+
+/**
+ * @brief Sleeps until the given HAL tick or until any interrupt occurs
+ *
+ * The function returns immediately if the wakeup tick has already been
+ * reached. The maximum sleep time is limited by the 24bit SysTick counter
+ * (approx. 130ms at 128MHz), the caller has to call the function again
+ * if the wakeup tick hasn't been reached yet.
+ *
+ * The caller may disable the interrupts before calling this function to
+ * check for pending work without a race. The interrupt state is restored
+ * before the function returns, pending interrupts still wake up the core.
+ *
+ * @param wakeTick      HAL tick at which the core has to be awake again
+ *
+ * @return IDLE_ERR_OK if no error occured
+ */
+int32_t idleSleepUntil(uint32_t wakeTick);
+
+#endif
@@ -0,0 +1,120 @@
+/******************************************************************************
+ * @file WorkQueue.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the deferred work queue
+ *
+ * @details The producer only writes the head index, the consumer only the
+ * tail index. A work item is completely written before the head index is
+ * published, so the queue needs no interrupt lock.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "WorkQueue.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+
+/**
+ * @brief Compiler barrier, which keeps the item access and the index update
+ * in order. The Cortex-M4 has no data cache and a single core, so no
+ * hardware barrier is needed between an interrupt and the thread.
+ */
+#define WORKQ_BARRIER()             __asm volatile ("" ::: "memory")
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+int32_t workqInitialize(WorkQueue* pQueue, WorkItem* pBuffer, uint32_t size)
+{
+    if (pQueue == 0 || pBuffer == 0)
+        return WORKQ_ERR_INVALID_PTR;
+
+    // Size must be a power of two
+    if (size == 0 || (size & (size - 1)) != 0)
+        return WORKQ_ERR_INVALID_PARAM;
+
+    pQueue->pItems          = pBuffer;
+    pQueue->mask            = size - 1;
+    pQueue->head            = 0;
+    pQueue->tail            = 0;
+    pQueue->overflowCount   = 0;
+
+    return WORKQ_ERR_OK;
+}
+
+
+int32_t workqPost(WorkQueue* pQueue, WorkFunction pFunction, uint32_t payload)
+{
+    uint32_t head = pQueue->head;
+
+    if ((head - pQueue->tail) > pQueue->mask)
+    {
+        pQueue->overflowCount++;
+        return WORKQ_ERR_FULL;
+    }
+
+    WorkItem* pItem = &(pQueue->pItems[head & pQueue->mask]);
+    pItem->pFunction    = pFunction;
+    pItem->payload      = payload;
+
+    // Publish the item only after it has been written completely
+    WORKQ_BARRIER();
+    pQueue->head = head + 1;
+
+    return WORKQ_ERR_OK;
+}
+
+
+uint32_t workqRun(WorkQueue* pQueue, uint32_t maxItems)
+{
+    uint32_t tail = pQueue->tail;
+    uint32_t count = 0;
+
+    while (count < maxItems && tail != pQueue->head)
+    {
+        WORKQ_BARRIER();
+
+        WorkItem item = pQueue->pItems[tail & pQueue->mask];
+
+        // Release the slot before executing, so the producer can reuse it
+        WORKQ_BARRIER();
+        tail++;
+        pQueue->tail = tail;
+
+        item.pFunction(item.payload);
+        count++;
+    }
+
+    return count;
+}
+
+
+bool workqIsPending(WorkQueue* pQueue)
+{
+    return pQueue->head != pQueue->tail;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
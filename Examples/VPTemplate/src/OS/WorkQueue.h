@@ -0,0 +1,124 @@
+/******************************************************************************
+ * @file WorkQueue.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header File for the deferred work queue
+ *
+ * @details A work queue is a lock-free single-producer/single-consumer ring
+ * of work items (function pointer plus payload). Interrupt handlers post
+ * work items, which are executed later in task context by the scheduler.
+ *
+ * Each queue must only have one producer. Interrupts with the same NVIC
+ * priority can't preempt each other, so they count as one producer and
+ * can share a queue. Interrupts with different priorities need separate
+ * queues.
+ *
+ *
+ *****************************************************************************/
+#ifndef _WORK_QUEUE_H_
+#define _WORK_QUEUE_H_
+
+
+/***** INCLUDES **************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define WORKQ_ERR_OK                0           //!< No error occured (Work Queue)
+#define WORKQ_ERR_INVALID_PTR       -1          //!< Invalid pointer (Work Queue)
+#define WORKQ_ERR_INVALID_PARAM     -2          //!< Invalid parameter value (Work Queue)
+#define WORKQ_ERR_FULL              -3          //!< Queue is full, the work item has been dropped (Work Queue)
+
+/***** TYPES *****************************************************************/
+
+/**
+ * @brief Function pointer for a deferred work function
+ *
+ */
+typedef void (*WorkFunction)(uint32_t payload);
+
+/**
+ * @brief Struct which represents a single work item
+ *
+ */
+typedef struct _WorkItem
+{
+    WorkFunction pFunction;             //!< Function to execute
+    uint32_t payload;                   //!< Payload passed to the function (value or pointer)
+} WorkItem;
+
+/**
+ * @brief Struct which represents a work queue
+ *
+ * The head and tail indices are free running, the position in the
+ * buffer is calculated with the mask.
+ *
+ */
+typedef struct _WorkQueue
+{
+    WorkItem* pItems;                   //!< Buffer for the work items (size must be a power of two)
+    uint32_t mask;                      //!< Size of the buffer - 1
+
+    volatile uint32_t head;             //!< Index of the next item to write (only changed by the producer)
+    volatile uint32_t tail;             //!< Index of the next item to read (only changed by the consumer)
+
+    volatile uint32_t overflowCount;    //!< Number of work items dropped because the queue was full
+} WorkQueue;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Initializes a work queue with the provided buffer
+ *
+ * @param pQueue        Pointer to the work queue
+ * @param pBuffer       Buffer for the work items
+ * @param size          Number of items in the buffer (must be a power of two)
+ *
+ * @return WORKQ_ERR_OK if no error occured
+ */
+int32_t workqInitialize(WorkQueue* pQueue, WorkItem* pBuffer, uint32_t size);
+
+/**
+ * @brief Posts a work item to the queue (producer side, e.g. ISR)
+ *
+ * @remark: No pointer checks are done to keep the ISR path short
+ *
+ * @param pQueue        Pointer to the work queue
+ * @param pFunction     Function which should be executed
+ * @param payload       Payload passed to the function
+ *
+ * @return WORKQ_ERR_OK if no error occured, WORKQ_ERR_FULL if the
+ * item has been dropped
+ */
+int32_t workqPost(WorkQueue* pQueue, WorkFunction pFunction, uint32_t payload);
+
+/**
+ * @brief Executes pending work items (consumer side, task context)
+ *
+ * @param pQueue        Pointer to the work queue
+ * @param maxItems      Maximum number of items to execute
+ *
+ * @return Number of executed items
+ */
+uint32_t workqRun(WorkQueue* pQueue, uint32_t maxItems);
+
+/**
+ * @brief Checks whether work items are pending in the queue
+ *
+ * @param pQueue        Pointer to the work queue
+ *
+ * @return true if at least one item is pending
+ */
+bool workqIsPending(WorkQueue* pQueue);
+
+#endif
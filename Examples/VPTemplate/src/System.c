@@ -239,6 +239,19 @@ void Error_Handler(void)
 }
 
 
+void SystemCycleCounter_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t SystemCycleCounter_Get(void)
+{
+    return DWT->CYCCNT;
+}
+
+
 /***** PRIVATE FUNCTIONS *****************************************************/
 
 
@@ -17,7 +17,7 @@
 #define _SYSTEM_H
 
 /***** INCLUDES **************************************************************/
-
+#include <stdint.h>
 
 /***** CONSTANTS *************************************************************/
 
@@ -47,5 +47,22 @@ void SystemClock_Config(void);
   */
 void Error_Handler(void);
 
+/**
+  * @brief Enables the DWT cycle counter of the Cortex-M4 core
+  *
+  * @retval None
+  */
+void SystemCycleCounter_Init(void);
+
+/**
+  * @brief Reads the current value of the DWT cycle counter
+  *
+  * @details The counter runs with the core clock and wraps around after
+  * 2^32 cycles
+  *
+  * @retval Current value of the cycle counter
+  */
+uint32_t SystemCycleCounter_Get(void);
+
 
 #endif
@@ -15,17 +15,25 @@
 
  /***** INCLUDES **************************************************************/
 #include "Filter.h"
+#include "FixedPoint/FixedPoint.h"
 
 /***** PRIVATE CONSTANTS *****************************************************/
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define FILTER_Q15_ONE                  32768   //!< 1.0 as Q15 value
+#define FILTER_Q15_PRODUCT_SHIFT        8       //!< Truncation of the Q30 products to the 22 fractional bits of the FMAC accumulator
+#define FILTER_Q15_OUTPUT_SHIFT         7       //!< Shift from 22 fractional bits of the accumulator to Q15
 
 
 /***** PRIVATE TYPES *********************************************************/
 
 
 /***** PRIVATE PROTOTYPES ****************************************************/
+static void filterSetStateEMA(EMAFilterData_t* pEMA, int32_t value);
+static inline int32_t filterStepEMA(EMAFilterData_t* pEMA, int32_t sensorValue);
+static void filterPushHistory(int16_t* pHistory, uint32_t length, const int16_t* pSamples, uint32_t count);
+static inline uint32_t filterWrapIndex(uint32_t index, uint32_t size);
 
 
 /***** PRIVATE VARIABLES *****************************************************/
@@ -35,15 +43,901 @@
 
 int32_t filterInitEMA(EMAFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha, bool resetFilter)
 {
-    return 0;
+    if (pEMA == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (scalingFactor <= 0 || alpha <= 0 || alpha > scalingFactor)
+        return FILTER_ERR_INVALID_PARAM;
+
+    pEMA->alpha         = alpha;
+    pEMA->scalingFactor = scalingFactor;
+
+    // Shift path if scalingFactor / alpha is an integer power of two
+    int32_t ratio = scalingFactor / alpha;
+    pEMA->isPowerOfTwo  = ((scalingFactor % alpha) == 0) && ((ratio & (ratio - 1)) == 0);
+    pEMA->shift         = 0;
+    pEMA->coefficient   = 0;
+
+    if (pEMA->isPowerOfTwo == true)
+    {
+        while ((1L << pEMA->shift) < ratio)
+        {
+            pEMA->shift++;
+        }
+    }
+    else
+    {
+        pEMA->coefficient = (int32_t)((((int64_t)alpha << 31) + scalingFactor / 2) / scalingFactor);
+    }
+
+    if (resetFilter == true)
+    {
+        filterResetEMA(pEMA);
+    }
+    else if (pEMA->firstValueAvailable == true)
+    {
+        // Continue with the last output in the representation of the new path
+        filterSetStateEMA(pEMA, pEMA->previousValue);
+    }
+
+    return FILTER_ERR_OK;
 }
 
 int32_t filterResetEMA(EMAFilterData_t* pEMA)
 {
-    return 0;
+    if (pEMA == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    pEMA->firstValueAvailable   = false;
+    pEMA->previousValue         = 0;
+    pEMA->state                 = 0;
+
+    return FILTER_ERR_OK;
 }
 
 int32_t filterEMA(EMAFilterData_t* pEMA, int32_t sensorValue)
 {
-    return 0;
-}
\ No newline at end of file
+    if (pEMA == 0)
+        return 0;
+
+    if (pEMA->firstValueAvailable == false)
+    {
+        filterSetStateEMA(pEMA, sensorValue);
+        pEMA->previousValue         = sensorValue;
+        pEMA->firstValueAvailable   = true;
+
+        return sensorValue;
+    }
+
+    pEMA->previousValue = filterStepEMA(pEMA, sensorValue);
+
+    return pEMA->previousValue;
+}
+
+int32_t filterEMABlock(EMAFilterData_t* pEMA, const int32_t* pInput, int32_t* pOutput, uint32_t count)
+{
+    return filterEMAFrames(pEMA, 1, pInput, pOutput, count);
+}
+
+int32_t filterEMAFrames(EMAFilterData_t* pEMA, uint32_t channels, const int32_t* pFrames, int32_t* pOutput,
+                        uint32_t frameCount)
+{
+    if (pEMA == 0 || pFrames == 0 || pOutput == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (channels == 0)
+        return FILTER_ERR_INVALID_PARAM;
+
+    if (frameCount == 0)
+        return FILTER_ERR_OK;
+
+    for (uint32_t c = 0; c < channels; c++)
+    {
+        EMAFilterData_t* pChannel = &pEMA[c];
+        const int32_t* pIn = &pFrames[c];
+        int32_t* pOut = &pOutput[c];
+        uint32_t n = frameCount;
+        int32_t output = pChannel->previousValue;
+
+        if (pChannel->firstValueAvailable == false)
+        {
+            filterSetStateEMA(pChannel, *pIn);
+            pChannel->firstValueAvailable = true;
+            output = *pIn;
+            *pOut = output;
+            pIn += channels;
+            pOut += channels;
+            n--;
+        }
+
+        // The path is selected once per buffer and the state is kept in a
+        // local variable (register) within the loop
+        int32_t state = pChannel->state;
+
+        if (pChannel->isPowerOfTwo == true)
+        {
+            uint8_t shift = pChannel->shift;
+            int32_t round = (shift > 0) ? (1L << (shift - 1)) : 0;
+
+            while (n-- > 0)
+            {
+                state += *pIn - ((state + round) >> shift);
+                output = (state + round) >> shift;
+                *pOut = output;
+                pIn += channels;
+                pOut += channels;
+            }
+        }
+        else
+        {
+            int32_t coefficient = pChannel->coefficient;
+
+            while (n-- > 0)
+            {
+                int32_t diff = *pIn * (1L << FILTER_EMA_FRAC_BITS) - state;
+                state += (int32_t)(((int64_t)diff * coefficient + (1LL << 30)) >> 31);
+                output = (state + (1L << (FILTER_EMA_FRAC_BITS - 1))) >> FILTER_EMA_FRAC_BITS;
+                *pOut = output;
+                pIn += channels;
+                pOut += channels;
+            }
+        }
+
+        pChannel->state = state;
+        pChannel->previousValue = output;
+    }
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterInitEMADual(EMADualFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha)
+{
+    if (pEMA == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (scalingFactor <= 0 || alpha <= 0 || alpha > scalingFactor)
+        return FILTER_ERR_INVALID_PARAM;
+
+    // Both coefficients must fit into a signed 16bit lane
+    int32_t alphaQ15 = (int32_t)((((int64_t)alpha * FILTER_Q15_ONE) + scalingFactor / 2) / scalingFactor);
+
+    if (alphaQ15 < 1)
+        alphaQ15 = 1;
+
+    if (alphaQ15 > FILTER_Q15_ONE - 1)
+        alphaQ15 = FILTER_Q15_ONE - 1;
+
+    pEMA->coefficients          = fixPack16(alphaQ15, FILTER_Q15_ONE - alphaQ15);
+    pEMA->state                 = 0;
+    pEMA->firstValueAvailable   = false;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterEMADual(EMADualFilterData_t* pEMA, const uint16_t* pSamples, uint16_t* pOutput, uint32_t stride,
+                      uint32_t frameCount)
+{
+    if (pEMA == 0 || pSamples == 0 || pOutput == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (stride < 2 || (stride & 1) != 0 || (((uintptr_t)pSamples | (uintptr_t)pOutput) & 3) != 0)
+        return FILTER_ERR_INVALID_PARAM;
+
+    const uint32_t* pIn = (const uint32_t*)pSamples;
+    uint32_t* pOut = (uint32_t*)pOutput;
+    uint32_t wordStride = stride / 2;
+    uint32_t coefficients = pEMA->coefficients;
+    uint32_t state = pEMA->state;
+    const uint32_t round = (1UL << 14);
+    const uint32_t outputRound = (1UL << (FILTER_EMA_DUAL_FRAC_BITS - 1)) * 0x00010001UL;
+    const uint32_t outputMask = (0xFFFFUL >> FILTER_EMA_DUAL_FRAC_BITS) * 0x00010001UL;
+
+    if (frameCount == 0)
+        return FILTER_ERR_OK;
+
+    if (pEMA->firstValueAvailable == false)
+    {
+        state = *pIn << FILTER_EMA_DUAL_FRAC_BITS;
+        pEMA->firstValueAvailable = true;
+    }
+
+    while (frameCount-- > 0)
+    {
+        // Both 12bit samples are scaled at once, no bit crosses the lanes
+        uint32_t samples = *pIn << FILTER_EMA_DUAL_FRAC_BITS;
+
+        // Pair each sample with the previous output of its channel and
+        // calculate alpha * x + (1 - alpha) * y with a dual multiply accumulate
+        uint32_t pair0 = fixPack16(samples, state);
+        uint32_t pair1 = fixPack16(samples >> 16, state >> 16);
+
+        int32_t y0 = (int32_t)fixDualMacQ15(pair0, coefficients, round) >> 15;
+        int32_t y1 = (int32_t)fixDualMacQ15(pair1, coefficients, round) >> 15;
+
+        state = fixPack16(y0, y1);
+
+        // Round both lanes to the output resolution
+        *pOut = (fixDualAddQ15(state, outputRound) >> FILTER_EMA_DUAL_FRAC_BITS) & outputMask;
+
+        pIn += wordStride;
+        pOut += wordStride;
+    }
+
+    pEMA->state = state;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterInitEMABank(EMAFilterBank_t* pBank, uint32_t channels)
+{
+    if (pBank == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (channels == 0 || channels > FILTER_BANK_MAX_CHANNELS)
+        return FILTER_ERR_INVALID_PARAM;
+
+    pBank->channels = channels;
+
+    for (uint32_t c = 0; c < FILTER_BANK_MAX_CHANNELS; c++)
+    {
+        pBank->coefficient[c] = (1UL << 31);
+    }
+
+    return filterResetEMABank(pBank);
+}
+
+int32_t filterSetEMABankAlpha(EMAFilterBank_t* pBank, uint32_t channel, int32_t scalingFactor, int32_t alpha)
+{
+    if (pBank == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (channel >= pBank->channels || scalingFactor <= 0 || alpha <= 0 || alpha > scalingFactor)
+        return FILTER_ERR_INVALID_PARAM;
+
+    pBank->coefficient[channel] = (uint32_t)((((uint64_t)alpha << 31) + scalingFactor / 2) / scalingFactor);
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterResetEMABank(EMAFilterBank_t* pBank)
+{
+    if (pBank == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    for (uint32_t c = 0; c < FILTER_BANK_MAX_CHANNELS; c++)
+    {
+        pBank->state[c]     = 0;
+        pBank->output[c]    = 0;
+    }
+
+    pBank->firstValueAvailable = false;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterEMABank(EMAFilterBank_t* pBank, const int32_t* pFrames, uint32_t frameCount)
+{
+    if (pBank == 0 || pFrames == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    uint32_t channels = pBank->channels;
+    const uint32_t* pCoefficient = pBank->coefficient;
+    int32_t* pState = pBank->state;
+    int32_t* pOut = pBank->output;
+    const int32_t round = (1L << (FILTER_EMA_FRAC_BITS - 1));
+
+    if (frameCount == 0)
+        return FILTER_ERR_OK;
+
+    // The first frame is taken as it is
+    if (pBank->firstValueAvailable == false)
+    {
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            pState[c] = pFrames[c] * (1L << FILTER_EMA_FRAC_BITS);
+            pOut[c] = pFrames[c];
+        }
+
+        pBank->firstValueAvailable = true;
+        pFrames += channels;
+        frameCount--;
+    }
+
+    while (frameCount-- > 0)
+    {
+        // Same step as the generic path of filterEMA() for all channels
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            int32_t diff = pFrames[c] * (1L << FILTER_EMA_FRAC_BITS) - pState[c];
+
+            pState[c] += (int32_t)(((int64_t)diff * pCoefficient[c] + (1LL << 30)) >> 31);
+            pOut[c] = (pState[c] + round) >> FILTER_EMA_FRAC_BITS;
+        }
+
+        pFrames += channels;
+    }
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterInitQ15(FilterQ15Data_t* pFilter, const FilterQ15Config_t* pConfig, FilterQ15Backend pBackend)
+{
+    if (pFilter == 0 || pConfig == 0 || pConfig->pCoeffB == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (pConfig->countB < FILTER_Q15_MIN_TAPS_B || pConfig->countB > FILTER_Q15_MAX_TAPS || pConfig->gain > FILTER_Q15_MAX_GAIN)
+        return FILTER_ERR_INVALID_PARAM;
+
+    if (pConfig->type == FILTER_Q15_IIR)
+    {
+        if (pConfig->pCoeffA == 0)
+            return FILTER_ERR_INVALID_PTR;
+
+        if (pConfig->countA < 1 || pConfig->countA > FILTER_Q15_MAX_TAPS)
+            return FILTER_ERR_INVALID_PARAM;
+    }
+    else if (pConfig->type != FILTER_Q15_FIR)
+    {
+        return FILTER_ERR_INVALID_PARAM;
+    }
+
+    pFilter->config     = *pConfig;
+    pFilter->pBackend   = (pBackend != 0) ? pBackend : filterQ15Software;
+
+    // A FIR filter has no feedback
+    if (pConfig->type == FILTER_Q15_FIR)
+    {
+        pFilter->config.pCoeffA = 0;
+        pFilter->config.countA  = 0;
+    }
+
+    return filterResetQ15(pFilter);
+}
+
+int32_t filterResetQ15(FilterQ15Data_t* pFilter)
+{
+    if (pFilter == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    for (uint32_t i = 0; i < FILTER_Q15_MAX_TAPS; i++)
+    {
+        pFilter->historyX[i] = 0;
+        pFilter->historyY[i] = 0;
+    }
+
+    pFilter->unloaded = true;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterQ15Block(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count)
+{
+    if (pFilter == 0 || pInput == 0 || pOutput == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (pFilter->pBackend == 0)
+        return FILTER_ERR_GENERAL;
+
+    return pFilter->pBackend(pFilter, pInput, pOutput, count);
+}
+
+int32_t filterQ15Software(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count)
+{
+    if (pFilter == 0 || pInput == 0 || pOutput == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    const int16_t* pB = pFilter->config.pCoeffB;
+    const int16_t* pA = pFilter->config.pCoeffA;
+    uint32_t countB = pFilter->config.countB;
+    uint32_t countA = pFilter->config.countA;
+    uint32_t shift = FILTER_Q15_OUTPUT_SHIFT - pFilter->config.gain;
+    int16_t* pX = pFilter->historyX;
+    int16_t* pY = pFilter->historyY;
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        int16_t x = pInput[n];
+
+        // x[n - k] is pX[countB - 1 - k] and y[n - k] is pY[countA - k]
+        int32_t acc = ((int32_t)pB[0] * x) >> FILTER_Q15_PRODUCT_SHIFT;
+
+        for (uint32_t k = 1; k < countB; k++)
+        {
+            acc += ((int32_t)pB[k] * pX[countB - 1 - k]) >> FILTER_Q15_PRODUCT_SHIFT;
+        }
+
+        for (uint32_t k = 1; k <= countA; k++)
+        {
+            acc += ((int32_t)pA[k - 1] * pY[countA - k]) >> FILTER_Q15_PRODUCT_SHIFT;
+        }
+
+        // Gain and truncation to Q15 in one shift, clipped like the FMAC
+        filterPushHistory(pX, countB - 1, &x, 1);
+        pOutput[n] = fixSat16(acc >> shift);
+        filterPushHistory(pY, countA, &pOutput[n], 1);
+    }
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterQ15SetHistory(FilterQ15Data_t* pFilter, const int16_t* pInput, const int16_t* pOutput, uint32_t count)
+{
+    if (pFilter == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (pInput != 0)
+        filterPushHistory(pFilter->historyX, pFilter->config.countB - 1, pInput, count);
+
+    if (pOutput != 0)
+        filterPushHistory(pFilter->historyY, pFilter->config.countA, pOutput, count);
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterInitMovingAverage(MovingAverageFilterData_t* pFilter, int32_t* pBuffer, uint32_t windowSize)
+{
+    if (pFilter == 0 || pBuffer == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (windowSize == 0 || windowSize > (1UL << 31))
+        return FILTER_ERR_INVALID_PARAM;
+
+    pFilter->pBuffer    = pBuffer;
+    pFilter->windowSize = windowSize;
+    pFilter->reciprocal = (uint32_t)(((1ULL << 31) + windowSize - 1) / windowSize);
+
+    return filterResetMovingAverage(pFilter);
+}
+
+int32_t filterResetMovingAverage(MovingAverageFilterData_t* pFilter)
+{
+    if (pFilter == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    pFilter->firstValueAvailable    = false;
+    pFilter->index                  = 0;
+    pFilter->sum                    = 0;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterMovingAverage(MovingAverageFilterData_t* pFilter, int32_t sensorValue)
+{
+    if (pFilter == 0)
+        return 0;
+
+    uint32_t windowSize = pFilter->windowSize;
+
+    if (pFilter->firstValueAvailable == false)
+    {
+        for (uint32_t i = 0; i < windowSize; i++)
+        {
+            pFilter->pBuffer[i] = sensorValue;
+        }
+
+        pFilter->sum = sensorValue * (int32_t)windowSize;
+        pFilter->index = 0;
+        pFilter->firstValueAvailable = true;
+
+        return sensorValue;
+    }
+
+    // Replace the oldest sample of the window
+    pFilter->sum += sensorValue - pFilter->pBuffer[pFilter->index];
+    pFilter->pBuffer[pFilter->index] = sensorValue;
+    pFilter->index = filterWrapIndex(pFilter->index + 1, windowSize);
+
+    // sum / windowSize rounded to nearest (half away from zero) with the
+    // reciprocal, calculated on the magnitude so both signs round the same
+    int32_t sum = pFilter->sum;
+    uint32_t magnitude = (sum < 0) ? (0U - (uint32_t)sum) : (uint32_t)sum;
+    uint32_t mean = (uint32_t)(((uint64_t)(magnitude + windowSize / 2) * pFilter->reciprocal) >> 31);
+
+    return (sum < 0) ? -(int32_t)mean : (int32_t)mean;
+}
+
+int32_t filterInitMinMax(MinMaxFilterData_t* pFilter, MinMaxFilterEntry_t* pDeque, uint32_t windowSize,
+                         FilterExtremum_t extremum)
+{
+    if (pFilter == 0 || pDeque == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (windowSize == 0 || (extremum != FILTER_MINIMUM && extremum != FILTER_MAXIMUM))
+        return FILTER_ERR_INVALID_PARAM;
+
+    pFilter->pDeque     = pDeque;
+    pFilter->windowSize = windowSize;
+    pFilter->extremum   = extremum;
+
+    return filterResetMinMax(pFilter);
+}
+
+int32_t filterResetMinMax(MinMaxFilterData_t* pFilter)
+{
+    if (pFilter == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    pFilter->head       = 0;
+    pFilter->count      = 0;
+    pFilter->sequence   = 0;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterMinMax(MinMaxFilterData_t* pFilter, int32_t sensorValue)
+{
+    if (pFilter == 0)
+        return 0;
+
+    MinMaxFilterEntry_t* pDeque = pFilter->pDeque;
+    uint32_t windowSize = pFilter->windowSize;
+    uint32_t sequence = pFilter->sequence;
+
+    // The front entry leaves the window (at most one per sample)
+    if (pFilter->count > 0 && sequence - pDeque[pFilter->head].sequence >= windowSize)
+    {
+        pFilter->head = filterWrapIndex(pFilter->head + 1, windowSize);
+        pFilter->count--;
+    }
+
+    // Entries at the back which are not better than the new sample can
+    // never become the extremum anymore
+    while (pFilter->count > 0)
+    {
+        int32_t value = pDeque[filterWrapIndex(pFilter->head + pFilter->count - 1, windowSize)].value;
+
+        if (pFilter->extremum == FILTER_MAXIMUM ? (value > sensorValue) : (value < sensorValue))
+            break;
+
+        pFilter->count--;
+    }
+
+    MinMaxFilterEntry_t* pBack = &pDeque[filterWrapIndex(pFilter->head + pFilter->count, windowSize)];
+    pBack->value    = sensorValue;
+    pBack->sequence = sequence;
+
+    pFilter->count++;
+    pFilter->sequence = sequence + 1;
+
+    return pDeque[pFilter->head].value;
+}
+
+int32_t filterInitMedian(MedianFilterData_t* pFilter, int32_t* pBuffer, uint32_t windowSize)
+{
+    if (pFilter == 0 || pBuffer == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if ((windowSize & 1) == 0)
+        return FILTER_ERR_INVALID_PARAM;
+
+    pFilter->pBuffer    = pBuffer;
+    pFilter->windowSize = windowSize;
+
+    return filterResetMedian(pFilter);
+}
+
+int32_t filterResetMedian(MedianFilterData_t* pFilter)
+{
+    if (pFilter == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    pFilter->firstValueAvailable    = false;
+    pFilter->index                  = 0;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterMedian(MedianFilterData_t* pFilter, int32_t sensorValue)
+{
+    if (pFilter == 0)
+        return 0;
+
+    uint32_t windowSize = pFilter->windowSize;
+    int32_t* pWindow = pFilter->pBuffer;
+    int32_t* pSorted = pFilter->pBuffer + windowSize;
+
+    if (pFilter->firstValueAvailable == false)
+    {
+        for (uint32_t i = 0; i < windowSize; i++)
+        {
+            pWindow[i] = sensorValue;
+            pSorted[i] = sensorValue;
+        }
+
+        pFilter->index = 0;
+        pFilter->firstValueAvailable = true;
+
+        return sensorValue;
+    }
+
+    // Replace the oldest sample of the window
+    int32_t oldest = pWindow[pFilter->index];
+    pWindow[pFilter->index] = sensorValue;
+    pFilter->index = filterWrapIndex(pFilter->index + 1, windowSize);
+
+    // Find the oldest sample in the sorted array (binary search)
+    uint32_t low = 0;
+    uint32_t high = windowSize - 1;
+
+    while (low < high)
+    {
+        uint32_t middle = (low + high) / 2;
+
+        if (pSorted[middle] < oldest)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    // Move the new sample from there to its sorted position
+    uint32_t position = low;
+
+    if (sensorValue > oldest)
+    {
+        while (position + 1 < windowSize && pSorted[position + 1] < sensorValue)
+        {
+            pSorted[position] = pSorted[position + 1];
+            position++;
+        }
+    }
+    else
+    {
+        while (position > 0 && pSorted[position - 1] > sensorValue)
+        {
+            pSorted[position] = pSorted[position - 1];
+            position--;
+        }
+    }
+
+    pSorted[position] = sensorValue;
+
+    return pSorted[windowSize / 2];
+}
+
+
+int32_t filterInitCICBank(CICFilterBank_t* pBank, uint32_t channels, uint8_t order, uint8_t decimationShift)
+{
+    if (pBank == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (channels == 0 || channels > FILTER_BANK_MAX_CHANNELS || order == 0 || order > FILTER_CIC_MAX_ORDER
+        || order * decimationShift > FILTER_CIC_MAX_GAIN_BITS)
+        return FILTER_ERR_INVALID_PARAM;
+
+    pBank->channels         = channels;
+    pBank->order            = order;
+    pBank->decimationShift  = decimationShift;
+
+    return filterResetCICBank(pBank);
+}
+
+int32_t filterResetCICBank(CICFilterBank_t* pBank)
+{
+    if (pBank == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    for (uint32_t k = 0; k < FILTER_CIC_MAX_ORDER; k++)
+    {
+        for (uint32_t c = 0; c < FILTER_BANK_MAX_CHANNELS; c++)
+        {
+            pBank->integrator[k][c] = 0;
+            pBank->comb[k][c]       = 0;
+        }
+    }
+
+    for (uint32_t c = 0; c < FILTER_BANK_MAX_CHANNELS; c++)
+    {
+        pBank->output[c] = 0;
+    }
+
+    pBank->count = 0;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterCICBank(CICFilterBank_t* pBank, const int32_t* pFrames, uint32_t frameCount)
+{
+    if (pBank == 0 || pFrames == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    uint32_t channels = pBank->channels;
+    uint32_t order = pBank->order;
+    uint32_t gainShift = order * pBank->decimationShift;
+    uint32_t round = (gainShift > 0) ? (1UL << (gainShift - 1)) : 0;
+    int32_t outputFrames = 0;
+
+    while (frameCount-- > 0)
+    {
+        // Integrators at the input rate (unsigned, the wrap around is intended)
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            uint32_t value = (uint32_t)pFrames[c];
+
+            for (uint32_t k = 0; k < order; k++)
+            {
+                pBank->integrator[k][c] += value;
+                value = pBank->integrator[k][c];
+            }
+        }
+
+        pFrames += channels;
+
+        if (++pBank->count < (1UL << pBank->decimationShift))
+            continue;
+
+        // Combs at the output rate, then normalized to the gain 1
+        pBank->count = 0;
+
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            uint32_t value = pBank->integrator[order - 1][c];
+
+            for (uint32_t k = 0; k < order; k++)
+            {
+                uint32_t delayed = pBank->comb[k][c];
+
+                pBank->comb[k][c] = value;
+                value -= delayed;
+            }
+
+            pBank->output[c] = (int32_t)(value + round) >> gainShift;
+        }
+
+        outputFrames++;
+    }
+
+    return outputFrames;
+}
+
+
+int32_t filterInitTracker(TrackerFilterData_t* pTracker, uint32_t alpha, uint32_t beta)
+{
+    if (pTracker == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    if (alpha == 0 || alpha > (1UL << 31) || beta > (1UL << 31))
+        return FILTER_ERR_INVALID_PARAM;
+
+    pTracker->alpha = alpha;
+    pTracker->beta  = beta;
+
+    return filterResetTracker(pTracker);
+}
+
+int32_t filterResetTracker(TrackerFilterData_t* pTracker)
+{
+    if (pTracker == 0)
+        return FILTER_ERR_INVALID_PTR;
+
+    pTracker->valueCount    = 0;
+    pTracker->estimate      = 0;
+    pTracker->rate          = 0;
+
+    return FILTER_ERR_OK;
+}
+
+int32_t filterTracker(TrackerFilterData_t* pTracker, int32_t sensorValue)
+{
+    if (pTracker == 0)
+        return 0;
+
+    int32_t measurement = sensorValue * (1L << FILTER_TRACKER_FRAC_BITS);
+
+    // The first value is taken as it is, the second one sets the rate
+    if (pTracker->valueCount < 2)
+    {
+        pTracker->rate = (pTracker->valueCount == 0) ? 0 : measurement - pTracker->estimate;
+        pTracker->estimate = measurement;
+        pTracker->valueCount++;
+
+        return sensorValue;
+    }
+
+    // Prediction with the rate, correction with the residual
+    int32_t predicted = pTracker->estimate + pTracker->rate;
+    int32_t residual = measurement - predicted;
+
+    pTracker->estimate = predicted + (int32_t)(((int64_t)residual * pTracker->alpha + (1LL << 30)) >> 31);
+    pTracker->rate += (int32_t)(((int64_t)residual * pTracker->beta + (1LL << 30)) >> 31);
+
+    return (pTracker->estimate + (1L << (FILTER_TRACKER_FRAC_BITS - 1))) >> FILTER_TRACKER_FRAC_BITS;
+}
+
+int32_t filterTrackerRate(const TrackerFilterData_t* pTracker)
+{
+    if (pTracker == 0)
+        return 0;
+
+    return pTracker->rate;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Sets the internal state of the EMA filter to the given output value
+ *
+ * @param pEMA              Pointer to the EMA filter struct
+ * @param value             Output value of the filter
+ */
+static void filterSetStateEMA(EMAFilterData_t* pEMA, int32_t value)
+{
+    if (pEMA->isPowerOfTwo == true)
+        pEMA->state = value * (1L << pEMA->shift);
+    else
+        pEMA->state = value * (1L << FILTER_EMA_FRAC_BITS);
+}
+
+/**
+ * @brief Performs one filter step on the internal state
+ *
+ * @param pEMA              Pointer to the EMA filter struct (first value available)
+ * @param sensorValue       Value which should be filtered
+ *
+ * @return The filtered value
+ */
+static inline int32_t filterStepEMA(EMAFilterData_t* pEMA, int32_t sensorValue)
+{
+    if (pEMA->isPowerOfTwo == true)
+    {
+        // state = y * 2^shift, so y += (x - y) / 2^shift becomes
+        // state += x - y, with y rounded to nearest
+        uint8_t shift = pEMA->shift;
+        int32_t round = (shift > 0) ? (1L << (shift - 1)) : 0;
+
+        pEMA->state += sensorValue - ((pEMA->state + round) >> shift);
+        return (pEMA->state + round) >> shift;
+    }
+
+    // state = y * 2^FRAC_BITS, state += (x - y) * alpha / scalingFactor
+    // with the Q31 coefficient and rounding to nearest
+    int32_t diff = sensorValue * (1L << FILTER_EMA_FRAC_BITS) - pEMA->state;
+
+    pEMA->state += (int32_t)(((int64_t)diff * pEMA->coefficient + (1LL << 30)) >> 31);
+    return (pEMA->state + (1L << (FILTER_EMA_FRAC_BITS - 1))) >> FILTER_EMA_FRAC_BITS;
+}
+
+/**
+ * @brief Appends samples to a history buffer (oldest sample first), only
+ * the last length samples are kept
+ *
+ * @param pHistory          History buffer
+ * @param length            Number of samples in the history buffer
+ * @param pSamples          Samples to append (in order of time)
+ * @param count             Number of samples to append
+ */
+static void filterPushHistory(int16_t* pHistory, uint32_t length, const int16_t* pSamples, uint32_t count)
+{
+    if (count >= length)
+    {
+        for (uint32_t i = 0; i < length; i++)
+        {
+            pHistory[i] = pSamples[count - length + i];
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < length - count; i++)
+    {
+        pHistory[i] = pHistory[i + count];
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pHistory[length - count + i] = pSamples[i];
+    }
+}
+
+/**
+ * @brief Wraps an index of a ring buffer, which is at most one buffer size
+ * past the end, without a division
+ *
+ * @param index             Index (< 2 * size)
+ * @param size              Size of the ring buffer
+ *
+ * @return Index within the ring buffer
+ */
+static inline uint32_t filterWrapIndex(uint32_t index, uint32_t size)
+{
+    return (index >= size) ? (index - size) : index;
+}
@@ -10,6 +10,51 @@
  *
  * @brief Header file for Filter library
  *
+ * @details The EMA filter avoids any division per sample. If the ratio of
+ * scaling factor and alpha is a power of two (e.g. alpha = 1, scaling
+ * factor = 16 for alpha = 1/16), the filter only uses shifts. Otherwise
+ * alpha / scalingFactor is precomputed as Q31 value and applied with a
+ * single 32x32->64 bit multiply.
+ *
+ * In both cases the filter state keeps additional fractional bits and all
+ * shifts round to nearest, so the output settles exactly on a constant
+ * input and doesn't drift.
+ *
+ * The block functions filter a complete buffer (or interleaved frames of
+ * a DMA buffer) per call, so the parameter checks and the path selection
+ * are done once per buffer instead of once per sample. The dual filter
+ * processes two 12bit channels in packed 16bit lanes with the DSP
+ * instructions of the Cortex-M4 (a bit exact C version is used on other
+ * targets).
+ *
+ * The Q15 FIR and IIR (e.g. biquad) filters use the number format and
+ * arithmetic of the FMAC unit of the STM32G4. The block function calls the
+ * backend given at initialization: the software backend of this library
+ * (used on the host and on targets without FMAC) or a hardware backend like
+ * fmacFilterQ15() of the FMACModule.
+ *
+ * The EMA filter bank filters all channels of a multi-channel frame (e.g.
+ * one ADC scan sequence) in one pass. Its coefficients and states are
+ * stored as arrays (one entry per channel), so the loop over the channels
+ * has no branches and accesses memory linearly.
+ *
+ * The window filters (moving average, minimum/maximum and median) work on
+ * the last N samples, which are kept in a buffer provided by the caller.
+ * Their update cost doesn't grow with the window size (median: binary
+ * search plus a shift of the samples between the old and new position).
+ * Like the EMA filter, they take the first value after a reset as value
+ * of the whole window.
+ *
+ * The alpha-beta tracker estimates the value and its rate of change (the
+ * steady state of a Kalman filter for a constant rate model). It follows
+ * ramps without the lag of the EMA filter. Its gains are unsigned Q31
+ * values (see FilterDesign.h), the update has no division.
+ *
+ * The CIC decimator bank reduces the sample rate of multi-channel frames
+ * by a power of two with integrators and combs only (no multiplication).
+ * Its output is normalized to the gain 1, so it keeps the scale of the
+ * input and can be followed by the EMA filter bank.
+ *
  *
  *****************************************************************************/
 #ifndef _FILTER_H_
@@ -28,11 +73,36 @@
 #define FILTER_ERR_INVALID_PTR          -2      //!< Invalid pointer (Null Pointer)
 #define FILTER_ERR_INVALID_PARAM        -3      //!< Invalid parameter value
 
+#define FILTER_EMA_FRAC_BITS            8       //!< Fractional bits of the EMA state (generic path)
+#define FILTER_EMA_DUAL_FRAC_BITS       3       //!< Fractional bits of the dual EMA state (12bit input in 16bit lanes)
+
+#define FILTER_Q15_MIN_TAPS_B           2       //!< Min. number of feed forward coefficients of a Q15 filter (limit of the FMAC)
+#ifndef FILTER_Q15_MAX_TAPS
+#define FILTER_Q15_MAX_TAPS             16      //!< Max. number of feed forward and of feedback coefficients of a Q15 filter
+#endif
+#define FILTER_Q15_MAX_GAIN             7       //!< Max. output gain (as power of two) of a Q15 filter
+
+#ifndef FILTER_BANK_MAX_CHANNELS
+#define FILTER_BANK_MAX_CHANNELS        8       //!< Max. number of channels of an EMA filter bank
+#endif
+
+#define FILTER_TRACKER_FRAC_BITS        12      //!< Fractional bits of the value and rate of the alpha-beta tracker
+
+#define FILTER_CIC_MAX_ORDER            4       //!< Max. number of integrator/comb stages of a CIC decimator
+#define FILTER_CIC_MAX_GAIN_BITS        24      //!< Max. order * decimationShift of a CIC decimator
+
+#define FILTER_MEDIAN_BUFFER_SIZE(windowSize)   (2 * (windowSize))  //!< Number of int32_t values of the median buffer
+
 /***** TYPES *****************************************************************/
 
 /**
  * @brief Struct which represents a EMA filter
  *
+ * @remark: The input values must stay within +/- 2^(31 - shift) for the
+ * power of two path and within +/- 2^(30 - FILTER_EMA_FRAC_BITS) for the
+ * generic path. The generic path is exact for alpha / scalingFactor of at
+ * least 2^-FILTER_EMA_FRAC_BITS.
+ *
  */
 typedef struct _EMAFilterData
 {
@@ -40,8 +110,223 @@ typedef struct _EMAFilterData
     int32_t alpha;                              //!< Alpha value (filter constant) as scaled value
     int32_t previousValue;                      //!< Previous value of the filter output
     int32_t scalingFactor;                      //!< Used scaling factor
+
+    bool isPowerOfTwo;                          //!< Flag whether scalingFactor / alpha is a power of two (shift path)
+    uint8_t shift;                              //!< log2(scalingFactor / alpha) for the shift path
+    int32_t coefficient;                        //!< alpha / scalingFactor as Q31 value for the generic path
+    int32_t state;                              //!< Filter output with additional fractional bits
 } EMAFilterData_t;
 
+/**
+ * @brief Struct which represents two EMA filters with the same alpha, which
+ * are processed in parallel in the two 16bit lanes of a register
+ *
+ * @remark: The input must be unsigned 12bit values. alpha is rounded to
+ * Q15 and the state only has FILTER_EMA_DUAL_FRAC_BITS fractional bits, so
+ * on a constant input the output settles within +/- (0.5 + 1 / (16 * alpha))
+ * LSB. Use EMAFilterData_t if a higher accuracy is needed.
+ *
+ */
+typedef struct _EMADualFilterData
+{
+    bool firstValueAvailable;                   //!< Flag to indicate whether there was already a value set as prev value
+    uint32_t coefficients;                      //!< Packed Q15 coefficients: alpha (low lane) and 1 - alpha (high lane)
+    uint32_t state;                             //!< Packed filter outputs with FILTER_EMA_DUAL_FRAC_BITS (channel 0 in low lane)
+} EMADualFilterData_t;
+
+/**
+ * @brief Struct which represents a bank of EMA filters, one per channel of
+ * a multi-channel frame (struct of arrays)
+ *
+ * @remark: All channels use the generic path of the EMA filter with the
+ * coefficient as unsigned Q31 value (so alpha = 1 is exact). The input
+ * values must stay within +/- 2^(30 - FILTER_EMA_FRAC_BITS).
+ *
+ */
+typedef struct _EMAFilterBank
+{
+    bool firstValueAvailable;                               //!< Flag to indicate whether there was already a frame
+    uint32_t channels;                                      //!< Number of channels per frame
+    uint32_t coefficient[FILTER_BANK_MAX_CHANNELS];         //!< alpha / scalingFactor per channel as unsigned Q31 value
+    int32_t state[FILTER_BANK_MAX_CHANNELS];                //!< Filter outputs with FILTER_EMA_FRAC_BITS per channel
+    int32_t output[FILTER_BANK_MAX_CHANNELS];               //!< Last filter output per channel
+} EMAFilterBank_t;
+
+/**
+ * @brief Enumeration of the Q15 filter structures
+ *
+ */
+typedef enum _FilterQ15Type
+{
+    FILTER_Q15_FIR,                             //!< FIR filter (convolution)
+    FILTER_Q15_IIR                              //!< IIR filter in direct form 1
+} FilterQ15Type_t;
+
+/**
+ * @brief Coefficients of a Q15 filter
+ *
+ * The filter calculates
+ *
+ *   y[n] = 2^gain * (sum(b[k] * x[n - k], k = 0..countB - 1)
+ *                  + sum(a[k] * y[n - k], k = 1..countA))
+ *
+ * Note that the feedback coefficients are added (as on the FMAC), so they
+ * have the opposite sign of the usual a[k] of a transfer function. The
+ * gain allows coefficients with a magnitude >= 1 (e.g. a[1] of a biquad
+ * with a low cutoff frequency), which are scaled down by 2^gain.
+ *
+ * The coefficients must stay valid as long as the filter is used.
+ *
+ */
+typedef struct _FilterQ15Config
+{
+    FilterQ15Type_t type;                       //!< Filter structure
+    const int16_t* pCoeffB;                     //!< Feed forward coefficients b[0] .. b[countB - 1] (Q15)
+    const int16_t* pCoeffA;                     //!< Feedback coefficients a[1] .. a[countA] (Q15, IIR only)
+    uint8_t countB;                             //!< Number of feed forward coefficients (FILTER_Q15_MIN_TAPS_B .. FILTER_Q15_MAX_TAPS)
+    uint8_t countA;                             //!< Number of feedback coefficients (IIR only)
+    uint8_t gain;                               //!< Output gain as power of two (0 .. FILTER_Q15_MAX_GAIN)
+} FilterQ15Config_t;
+
+typedef struct _FilterQ15Data FilterQ15Data_t;
+
+/**
+ * @brief Function pointer of a Q15 filter backend, which filters a block
+ * of samples (see filterQ15Block())
+ *
+ * A backend returns FILTER_ERR_* codes, errors of its own module are
+ * mapped to them.
+ */
+typedef int32_t (*FilterQ15Backend)(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count);
+
+/**
+ * @brief Struct which represents a Q15 FIR or IIR filter
+ *
+ * @remark: The software backend follows the FMAC data path: each product
+ * is truncated to 22 fractional bits, the sum is multiplied by the gain,
+ * truncated to Q15 and saturated.
+ *
+ */
+struct _FilterQ15Data
+{
+    FilterQ15Config_t config;                   //!< Coefficients and structure of the filter
+    FilterQ15Backend pBackend;                  //!< Backend which processes the blocks
+    int16_t historyX[FILTER_Q15_MAX_TAPS];      //!< Last countB - 1 input samples (oldest first)
+    int16_t historyY[FILTER_Q15_MAX_TAPS];      //!< Last countA output samples (oldest first, IIR only)
+    bool unloaded;                              //!< Set by filterResetQ15(), a hardware backend must reload the filter
+};
+
+/**
+ * @brief Struct which represents a moving average filter
+ *
+ * @remark: The mean is rounded to nearest without a division. It is exact
+ * as long as the magnitude of the sum of the window stays below
+ * 2^31 / windowSize (e.g. 12bit values up to a window size of 512).
+ *
+ */
+typedef struct _MovingAverageFilterData
+{
+    bool firstValueAvailable;                   //!< Flag to indicate whether there was already a value
+    int32_t* pBuffer;                           //!< Samples of the window (ring buffer of the caller)
+    uint32_t windowSize;                        //!< Number of samples of the window
+    uint32_t index;                             //!< Position of the oldest sample in the ring buffer
+    int32_t sum;                                //!< Sum of all samples of the window
+    uint32_t reciprocal;                        //!< ceil(2^31 / windowSize) for the division free mean
+} MovingAverageFilterData_t;
+
+/**
+ * @brief Enumeration of the window extremum which is tracked
+ *
+ */
+typedef enum _FilterExtremum
+{
+    FILTER_MINIMUM,                             //!< Minimum of the window
+    FILTER_MAXIMUM                              //!< Maximum of the window
+} FilterExtremum_t;
+
+/**
+ * @brief Entry of the deque of a minimum/maximum filter
+ */
+typedef struct _MinMaxFilterEntry
+{
+    int32_t value;                              //!< Sample value
+    uint32_t sequence;                          //!< Running number of the sample
+} MinMaxFilterEntry_t;
+
+/**
+ * @brief Struct which represents a sliding window minimum or maximum
+ * filter (monotonic deque)
+ *
+ * The deque only keeps the samples which can still become the extremum,
+ * in order of arrival, so its front is always the extremum of the window.
+ * Each sample is added and removed once (amortized O(1) per sample).
+ *
+ */
+typedef struct _MinMaxFilterData
+{
+    MinMaxFilterEntry_t* pDeque;                //!< Deque entries (ring buffer of the caller, windowSize entries)
+    uint32_t windowSize;                        //!< Number of samples of the window
+    uint32_t head;                              //!< Position of the front entry in the ring buffer
+    uint32_t count;                             //!< Number of entries in the deque
+    uint32_t sequence;                          //!< Running number of the next sample
+    FilterExtremum_t extremum;                  //!< Tracked extremum
+} MinMaxFilterData_t;
+
+/**
+ * @brief Struct which represents a sliding window median filter
+ *
+ * The caller buffer holds the samples in order of arrival (first half)
+ * and the same samples sorted (second half). Each new sample replaces the
+ * oldest one in the sorted array by an insertion step.
+ *
+ */
+typedef struct _MedianFilterData
+{
+    bool firstValueAvailable;                   //!< Flag to indicate whether there was already a value
+    int32_t* pBuffer;                           //!< Buffer of the caller (FILTER_MEDIAN_BUFFER_SIZE() values)
+    uint32_t windowSize;                        //!< Number of samples of the window (odd)
+    uint32_t index;                             //!< Position of the oldest sample
+} MedianFilterData_t;
+
+/**
+ * @brief Struct which represents an alpha-beta tracker
+ *
+ * Each update predicts the value with the rate, then corrects value and
+ * rate with alpha and beta times the residual of the new sample.
+ *
+ * @remark: The input values must stay within
+ * +/- 2^(29 - FILTER_TRACKER_FRAC_BITS).
+ *
+ */
+typedef struct _TrackerFilterData
+{
+    uint32_t valueCount;                        //!< Number of values since the reset (max. 2)
+    uint32_t alpha;                             //!< Gain of the value (unsigned Q31, max. 1.0)
+    uint32_t beta;                              //!< Gain of the rate (unsigned Q31, max. 1.0)
+    int32_t estimate;                           //!< Estimated value with FILTER_TRACKER_FRAC_BITS
+    int32_t rate;                               //!< Estimated change per sample with FILTER_TRACKER_FRAC_BITS
+} TrackerFilterData_t;
+
+/**
+ * @brief Struct which represents a bank of CIC decimators, one per channel
+ * of a multi-channel frame
+ *
+ * The integrators wrap around modulo 2^32, which the combs compensate. The
+ * result is exact as long as the magnitude of the input stays below
+ * 2^(31 - order * decimationShift).
+ *
+ */
+typedef struct _CICFilterBank
+{
+    uint32_t channels;                                                  //!< Number of channels per frame
+    uint8_t order;                                                      //!< Number of integrator and comb stages
+    uint8_t decimationShift;                                            //!< Decimation ratio as power of two
+    uint32_t count;                                                     //!< Number of input frames since the last output frame
+    uint32_t integrator[FILTER_CIC_MAX_ORDER][FILTER_BANK_MAX_CHANNELS];  //!< States of the integrators
+    uint32_t comb[FILTER_CIC_MAX_ORDER][FILTER_BANK_MAX_CHANNELS];      //!< Delayed inputs of the combs
+    int32_t output[FILTER_BANK_MAX_CHANNELS];                           //!< Last decimated frame
+} CICFilterBank_t;
+
 
 /***** PROTOTYPES ************************************************************/
 
@@ -54,7 +339,11 @@ typedef struct _EMAFilterData
  * @param alpha             Already scaled alpha factor (must be scaled with same scaling factor as supplied via parameter)
  * @param resetFilter       Flag to indicate whether the filter should be reset
  *
- * @return Return FILTER_ERR_OK is no error occured
+ * @remark: This is the only function with a division, the filter path and
+ * its coefficient are selected here.
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if not 0 < alpha <= scalingFactor
  */
 int32_t filterInitEMA(EMAFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha, bool resetFilter);
 
@@ -71,6 +360,8 @@ int32_t filterResetEMA(EMAFilterData_t* pEMA);
 /**
  * @brief Performs the EMA filtering on the provided sensor value
  *
+ * The first value after a reset is taken as it is.
+ *
  * @param pEMA              Pointer to the EMA filter struct
  * @param sensorValue       Value which should be filtered
  *
@@ -78,4 +369,363 @@ int32_t filterResetEMA(EMAFilterData_t* pEMA);
  */
 int32_t filterEMA(EMAFilterData_t* pEMA, int32_t sensorValue);
 
+/**
+ * @brief Performs the EMA filtering on a buffer of samples of one channel
+ *
+ * @param pEMA              Pointer to the EMA filter struct
+ * @param pInput            Input samples
+ * @param pOutput           Buffer for the filtered samples (may be the same as pInput)
+ * @param count             Number of samples
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterEMABlock(EMAFilterData_t* pEMA, const int32_t* pInput, int32_t* pOutput, uint32_t count);
+
+/**
+ * @brief Performs the EMA filtering on interleaved multi-channel frames,
+ * e.g. the buffer of an ADC scan sequence written by DMA
+ *
+ * Sample c of frame n is pFrames[n * channels + c] and is filtered by
+ * pEMA[c], the output has the same layout.
+ *
+ * @param pEMA              Array of one EMA filter struct per channel
+ * @param channels          Number of channels per frame
+ * @param pFrames           Interleaved input samples
+ * @param pOutput           Buffer for the filtered samples (may be the same as pFrames)
+ * @param frameCount        Number of frames
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterEMAFrames(EMAFilterData_t* pEMA, uint32_t channels, const int32_t* pFrames, int32_t* pOutput,
+                        uint32_t frameCount);
+
+/**
+ * @brief Initialize a dual EMA filter and resets its state
+ *
+ * @param pEMA              Pointer to the dual EMA filter struct
+ * @param scalingFactor     Scaling factor of alpha
+ * @param alpha             Already scaled alpha factor
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if not 0 < alpha <= scalingFactor
+ */
+int32_t filterInitEMADual(EMADualFilterData_t* pEMA, int32_t scalingFactor, int32_t alpha);
+
+/**
+ * @brief Performs the EMA filtering on two channels of interleaved 16bit
+ * frames (two channels per instruction)
+ *
+ * The two channels must be adjacent in each frame, the first one 32bit
+ * aligned. Sample n of the channels is read from pSamples[n * stride] and
+ * pSamples[n * stride + 1] and the output is written to the same position
+ * of pOutput.
+ *
+ * @param pEMA              Pointer to the dual EMA filter struct
+ * @param pSamples          First sample of the channel pair (32bit aligned)
+ * @param pOutput           Buffer for the filtered samples (may be the same as pSamples)
+ * @param stride            Number of 16bit samples per frame (must be even)
+ * @param frameCount        Number of frames
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterEMADual(EMADualFilterData_t* pEMA, const uint16_t* pSamples, uint16_t* pOutput, uint32_t stride,
+                      uint32_t frameCount);
+
+/**
+ * @brief Initialize a Q15 FIR or IIR filter and resets its state
+ *
+ * @param pFilter           Pointer to the Q15 filter struct
+ * @param pConfig           Coefficients and structure of the filter (copied)
+ * @param pBackend          Backend which processes the blocks (0 for the software backend)
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the number of coefficients or the gain is out of range (the limits are
+ * the same for all backends)
+ */
+int32_t filterInitQ15(FilterQ15Data_t* pFilter, const FilterQ15Config_t* pConfig, FilterQ15Backend pBackend);
+
+/**
+ * @brief Resets the state of a Q15 filter (all previous samples are 0)
+ *
+ * The filter is marked as unloaded, so a hardware backend which still holds
+ * the filter (or another filter at the same address) reloads it with the
+ * next block.
+ *
+ * @param pFilter           Pointer to the Q15 filter struct
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetQ15(FilterQ15Data_t* pFilter);
+
+/**
+ * @brief Performs the filtering on a block of Q15 samples with the backend
+ * of the filter
+ *
+ * @param pFilter           Pointer to the Q15 filter struct
+ * @param pInput            Input samples
+ * @param pOutput           Buffer for the filtered samples (may be the same as pInput)
+ * @param count             Number of samples
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the block is not supported by the backend, FILTER_ERR_GENERAL if the
+ * backend failed
+ */
+int32_t filterQ15Block(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count);
+
+/**
+ * @brief Software backend of the Q15 filters
+ *
+ * @param pFilter           Pointer to the Q15 filter struct
+ * @param pInput            Input samples
+ * @param pOutput           Buffer for the filtered samples (may be the same as pInput)
+ * @param count             Number of samples
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterQ15Software(FilterQ15Data_t* pFilter, const int16_t* pInput, int16_t* pOutput, uint32_t count);
+
+/**
+ * @brief Updates the state of a Q15 filter with the end of a block which
+ * was processed outside of the library (e.g. by a hardware backend)
+ *
+ * @param pFilter           Pointer to the Q15 filter struct
+ * @param pInput            Input samples of the block (0 to keep the input state)
+ * @param pOutput           Output samples of the block (0 to keep the output state)
+ * @param count             Number of samples of the block
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterQ15SetHistory(FilterQ15Data_t* pFilter, const int16_t* pInput, const int16_t* pOutput, uint32_t count);
+
+/**
+ * @brief Initialize a moving average filter and resets it
+ *
+ * @param pFilter           Pointer to the moving average filter struct
+ * @param pBuffer           Buffer for the samples of the window (windowSize values)
+ * @param windowSize        Number of samples of the window
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the window size is 0
+ */
+int32_t filterInitMovingAverage(MovingAverageFilterData_t* pFilter, int32_t* pBuffer, uint32_t windowSize);
+
+/**
+ * @brief Resets the moving average filter, the next value fills the window
+ *
+ * @param pFilter           Pointer to the moving average filter struct
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetMovingAverage(MovingAverageFilterData_t* pFilter);
+
+/**
+ * @brief Adds a value to the moving average filter
+ *
+ * @param pFilter           Pointer to the moving average filter struct
+ * @param sensorValue       Value which should be filtered
+ *
+ * @return The mean of the window
+ */
+int32_t filterMovingAverage(MovingAverageFilterData_t* pFilter, int32_t sensorValue);
+
+/**
+ * @brief Initialize a minimum or maximum filter and resets it
+ *
+ * @param pFilter           Pointer to the minimum/maximum filter struct
+ * @param pDeque            Buffer for the deque (windowSize entries)
+ * @param windowSize        Number of samples of the window
+ * @param extremum          Tracked extremum (FILTER_MINIMUM or FILTER_MAXIMUM)
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the window size is 0
+ */
+int32_t filterInitMinMax(MinMaxFilterData_t* pFilter, MinMaxFilterEntry_t* pDeque, uint32_t windowSize,
+                         FilterExtremum_t extremum);
+
+/**
+ * @brief Resets the minimum/maximum filter
+ *
+ * @param pFilter           Pointer to the minimum/maximum filter struct
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetMinMax(MinMaxFilterData_t* pFilter);
+
+/**
+ * @brief Adds a value to the minimum/maximum filter
+ *
+ * @param pFilter           Pointer to the minimum/maximum filter struct
+ * @param sensorValue       Value which should be filtered
+ *
+ * @return The minimum or maximum of the window
+ */
+int32_t filterMinMax(MinMaxFilterData_t* pFilter, int32_t sensorValue);
+
+/**
+ * @brief Initialize a median filter and resets it
+ *
+ * @param pFilter           Pointer to the median filter struct
+ * @param pBuffer           Buffer of FILTER_MEDIAN_BUFFER_SIZE(windowSize) values
+ * @param windowSize        Number of samples of the window (odd)
+ *
+ * @remark: The update cost grows with the distance of the new sample to
+ * the oldest one in the sorted window, the filter is meant for small
+ * windows (e.g. 3 .. 15 samples) to remove single spikes.
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the window size is not odd
+ */
+int32_t filterInitMedian(MedianFilterData_t* pFilter, int32_t* pBuffer, uint32_t windowSize);
+
+/**
+ * @brief Resets the median filter, the next value fills the window
+ *
+ * @param pFilter           Pointer to the median filter struct
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetMedian(MedianFilterData_t* pFilter);
+
+/**
+ * @brief Adds a value to the median filter
+ *
+ * @param pFilter           Pointer to the median filter struct
+ * @param sensorValue       Value which should be filtered
+ *
+ * @return The median of the window
+ */
+int32_t filterMedian(MedianFilterData_t* pFilter, int32_t sensorValue);
+
+/**
+ * @brief Initialize an EMA filter bank, all channels pass the values
+ * unfiltered (alpha = 1) until filterSetEMABankAlpha() is called
+ *
+ * @param pBank             Pointer to the EMA filter bank
+ * @param channels          Number of channels per frame (max. FILTER_BANK_MAX_CHANNELS)
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the number of channels is out of range
+ */
+int32_t filterInitEMABank(EMAFilterBank_t* pBank, uint32_t channels);
+
+/**
+ * @brief Sets the filter constant of one channel of an EMA filter bank
+ *
+ * @param pBank             Pointer to the EMA filter bank
+ * @param channel           Channel index within the frame
+ * @param scalingFactor     Scaling factor of alpha
+ * @param alpha             Already scaled alpha factor
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if the channel is out of range or not 0 < alpha <= scalingFactor
+ */
+int32_t filterSetEMABankAlpha(EMAFilterBank_t* pBank, uint32_t channel, int32_t scalingFactor, int32_t alpha);
+
+/**
+ * @brief Resets all channels of an EMA filter bank, the next frame is
+ * taken as it is
+ *
+ * @param pBank             Pointer to the EMA filter bank
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetEMABank(EMAFilterBank_t* pBank);
+
+/**
+ * @brief Filters interleaved multi-channel frames with the EMA filter bank
+ *
+ * Sample c of frame n is pFrames[n * channels + c], the filtered values of
+ * the last frame are stored in the output array of the bank.
+ *
+ * @param pBank             Pointer to the EMA filter bank
+ * @param pFrames           Interleaved input samples
+ * @param frameCount        Number of frames
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterEMABank(EMAFilterBank_t* pBank, const int32_t* pFrames, uint32_t frameCount);
+
+/**
+ * @brief Initialize a CIC decimator bank
+ *
+ * @param pBank             Pointer to the CIC decimator bank
+ * @param channels          Number of channels per frame (max. FILTER_BANK_MAX_CHANNELS)
+ * @param order             Number of integrator and comb stages (1 .. FILTER_CIC_MAX_ORDER)
+ * @param decimationShift   Decimation ratio as power of two (order * decimationShift
+ *                          max. FILTER_CIC_MAX_GAIN_BITS)
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if a parameter is out of range
+ */
+int32_t filterInitCICBank(CICFilterBank_t* pBank, uint32_t channels, uint8_t order, uint8_t decimationShift);
+
+/**
+ * @brief Resets all integrators and combs of a CIC decimator bank
+ *
+ * @param pBank             Pointer to the CIC decimator bank
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetCICBank(CICFilterBank_t* pBank);
+
+/**
+ * @brief Filters interleaved multi-channel frames with the CIC decimator
+ * bank
+ *
+ * Sample c of frame n is pFrames[n * channels + c]. After every
+ * 2^decimationShift input frames one output frame is calculated and stored
+ * in the output array of the bank (the last one if several are completed).
+ *
+ * @remark: After a reset the first order output frames are part of the
+ * step response of the filter.
+ *
+ * @param pBank             Pointer to the CIC decimator bank
+ * @param pFrames           Interleaved input samples
+ * @param frameCount        Number of input frames
+ *
+ * @return Number of completed output frames or FILTER_ERR_INVALID_PTR
+ */
+int32_t filterCICBank(CICFilterBank_t* pBank, const int32_t* pFrames, uint32_t frameCount);
+
+/**
+ * @brief Initialize an alpha-beta tracker
+ *
+ * @param pTracker          Pointer to the tracker struct
+ * @param alpha             Gain of the value (unsigned Q31, 0 < alpha <= 2^31)
+ * @param beta              Gain of the rate (unsigned Q31, beta <= 2^31)
+ *
+ * @return Return FILTER_ERR_OK is no error occured, FILTER_ERR_INVALID_PARAM
+ * if a gain is out of range
+ */
+int32_t filterInitTracker(TrackerFilterData_t* pTracker, uint32_t alpha, uint32_t beta);
+
+/**
+ * @brief Resets the tracker, the next value is taken as it is and the
+ * difference to the one after it as initial rate
+ *
+ * @param pTracker          Pointer to the tracker struct
+ *
+ * @return Return FILTER_ERR_OK is no error occured
+ */
+int32_t filterResetTracker(TrackerFilterData_t* pTracker);
+
+/**
+ * @brief Updates the tracker with a new value
+ *
+ * @param pTracker          Pointer to the tracker struct
+ * @param sensorValue       Value which should be filtered
+ *
+ * @return The estimated value (rounded)
+ */
+int32_t filterTracker(TrackerFilterData_t* pTracker, int32_t sensorValue);
+
+/**
+ * @brief Returns the estimated rate of change of the tracker
+ *
+ * @param pTracker          Pointer to the tracker struct
+ *
+ * @return Change per sample with FILTER_TRACKER_FRAC_BITS fractional bits
+ */
+int32_t filterTrackerRate(const TrackerFilterData_t* pTracker);
+
 #endif
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * @file FilterDesign.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file for the design of filter coefficients at build time
+ *
+ * @details The macros calculate the coefficients of the EMA filter and of
+ * Q15 biquads from a cutoff frequency and a sample rate. They only use
+ * constant expressions (no library functions, exp() and tan() are replaced
+ * by series), so the compiler evaluates them at build time and no floating
+ * point code is linked into the soft-float target.
+ *
+ * Use them to initialize static const variables, then the compiler must
+ * evaluate them and rejects any argument which is not a constant:
+ *
+ *   static const int32_t gAlpha = FILTER_EMA_ALPHA(2.0, TIMER_SAMPLE_RATE_HZ, 1024);
+ *
+ *   static const int16_t gLowPassB[3] = FILTER_BIQUAD_LOWPASS_B(5.0, TIMER_SAMPLE_RATE_HZ, FILTER_BIQUAD_Q_BUTTERWORTH);
+ *   static const int16_t gLowPassA[2] = FILTER_BIQUAD_LOWPASS_A(5.0, TIMER_SAMPLE_RATE_HZ, FILTER_BIQUAD_Q_BUTTERWORTH);
+ *
+ * The cutoff frequency must be below half of the sample rate.
+ *
+ * The gains of the alpha-beta tracker are given as alpha, beta follows
+ * from the Benedict-Bordner relation (best compromise of noise reduction
+ * and transient error):
+ *
+ *   filterInitTracker(&tracker, FILTER_TRACKER_ALPHA(0.2), FILTER_TRACKER_BETA(0.2));
+ *
+ *
+ *****************************************************************************/
+#ifndef _FILTER_DESIGN_H_
+#define _FILTER_DESIGN_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define FILTER_DESIGN_PI                3.14159265358979323846  //!< Pi
+#define FILTER_BIQUAD_Q_BUTTERWORTH     0.70710678118654752440  //!< Q of a second order Butterworth filter (1 / sqrt(2))
+#define FILTER_BIQUAD_GAIN              1                       //!< Gain of the Q15 biquad coefficients (FilterQ15Config_t::gain)
+
+/**
+ * @brief Rounds a constant to the nearest integer (half away from zero)
+ */
+#define FILTER_DESIGN_ROUND(x)          ((int32_t)((x) < 0.0 ? (x) - 0.5 : (x) + 0.5))
+
+/**
+ * @brief Square of a constant
+ */
+#define FILTER_DESIGN_SQUARE(x)         ((x) * (x))
+
+/**
+ * @brief exp(-x) for 0 <= x <= 1 (Taylor series up to x^8, error < 3e-6)
+ */
+#define FILTER_DESIGN_EXP_NEG_SMALL(x)                                                  \
+    (1.0 - (x) * (1.0 - (x) / 2.0 * (1.0 - (x) / 3.0 * (1.0 - (x) / 4.0                 \
+        * (1.0 - (x) / 5.0 * (1.0 - (x) / 6.0 * (1.0 - (x) / 7.0 * (1.0 - (x) / 8.0))))))))
+
+/**
+ * @brief exp(-x) for 0 <= x <= 8, as exp(-x / 8)^8 (relative error < 1e-8 for
+ * x <= pi, i.e. for all cutoff frequencies below half of the sample rate)
+ */
+#define FILTER_DESIGN_EXP_NEG(x)                                                        \
+    FILTER_DESIGN_SQUARE(FILTER_DESIGN_SQUARE(FILTER_DESIGN_SQUARE(FILTER_DESIGN_EXP_NEG_SMALL((x) / 8.0))))
+
+/**
+ * @brief tan(x) for 0 <= x < pi / 2 (continued fraction of Lambert, relative
+ * error < 1e-11 up to x = 1.5)
+ */
+#define FILTER_DESIGN_TAN(x)                                                            \
+    ((x) / (1.0 - FILTER_DESIGN_SQUARE(x) / (3.0 - FILTER_DESIGN_SQUARE(x) / (5.0       \
+        - FILTER_DESIGN_SQUARE(x) / (7.0 - FILTER_DESIGN_SQUARE(x) / (9.0               \
+        - FILTER_DESIGN_SQUARE(x) / (11.0 - FILTER_DESIGN_SQUARE(x) / (13.0             \
+        - FILTER_DESIGN_SQUARE(x) / (15.0 - FILTER_DESIGN_SQUARE(x) / 17.0)))))))))
+
+/**
+ * @brief Clips a constant to the range of int16_t
+ */
+#define FILTER_DESIGN_SAT16(x)          ((x) > 32767.0 ? 32767.0 : ((x) < -32768.0 ? -32768.0 : (x)))
+
+/**
+ * @brief Converts a coefficient to Q15, scaled down by 2^FILTER_BIQUAD_GAIN
+ * (rounded, saturated)
+ *
+ * The scaled feedback coefficient a1 of a biquad approaches 1.0 for low
+ * cutoff frequencies and is saturated to 32767 below fc / fs = 3.4e-6, then
+ * the Q15 coefficients are too coarse for the response anyway.
+ */
+#define FILTER_DESIGN_Q15(x)                                                            \
+    ((int16_t)FILTER_DESIGN_ROUND(FILTER_DESIGN_SAT16((x) * (32768.0 / (1 << FILTER_BIQUAD_GAIN)))))
+
+/**
+ * @brief Converts a constant 0 .. 1 to unsigned Q31 (1.0 = 2^31)
+ */
+#define FILTER_DESIGN_Q31(x)            ((uint32_t)((x) * 2147483648.0 + 0.5))
+
+/**
+ * @brief Gain of the value of the alpha-beta tracker (0 < alpha <= 1)
+ */
+#define FILTER_TRACKER_ALPHA(alpha)     FILTER_DESIGN_Q31(alpha)
+
+/**
+ * @brief Gain of the rate of the alpha-beta tracker for the given alpha
+ * (Benedict-Bordner: beta = alpha^2 / (2 - alpha))
+ */
+#define FILTER_TRACKER_BETA(alpha)      FILTER_DESIGN_Q31((alpha) * (alpha) / (2.0 - (alpha)))
+
+/**
+ * @brief Scaled alpha of the EMA filter (for filterInitEMA()) with a cutoff
+ * frequency of cutoffHz at a sample rate of sampleRateHz
+ *
+ * alpha = 1 - exp(-2 * pi * fc / fs) matches the time constant of an RC low
+ * pass. The scaling factor must be large enough that alpha is >= 1 (about
+ * scalingFactor >= fs / (2 * pi * fc)).
+ */
+#define FILTER_EMA_ALPHA(cutoffHz, sampleRateHz, scalingFactor)                         \
+    FILTER_DESIGN_ROUND((scalingFactor)                                                 \
+        * (1.0 - FILTER_DESIGN_EXP_NEG(2.0 * FILTER_DESIGN_PI * (cutoffHz) / (sampleRateHz))))
+
+/*
+ * Biquads (bilinear transform with prewarped cutoff frequency), with
+ * K = tan(pi * fc / fs) and n = 1 / (1 + K / Q + K^2):
+ *
+ *   low pass:   b = { K^2 * n, 2 * K^2 * n, K^2 * n }
+ *   high pass:  b = { n, -2 * n, n }
+ *   both:       a = { 2 * (K^2 - 1) * n, (1 - K / Q + K^2) * n }
+ *
+ * The feedback coefficients are negated for FilterQ15Config_t and all
+ * coefficients are scaled by 2^-FILTER_BIQUAD_GAIN, so they are used with
+ * countB = 3, countA = 2 and gain = FILTER_BIQUAD_GAIN.
+ */
+#define FILTER_BIQUAD_K(cutoffHz, sampleRateHz)                                         \
+    FILTER_DESIGN_TAN(FILTER_DESIGN_PI * (cutoffHz) / (sampleRateHz))
+
+#define FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)                                   \
+    (1.0 / (1.0 + FILTER_BIQUAD_K(cutoffHz, sampleRateHz) / (q)                         \
+        + FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz))))
+
+/**
+ * @brief Initializer of the 3 feed forward coefficients of a low pass biquad
+ */
+#define FILTER_BIQUAD_LOWPASS_B(cutoffHz, sampleRateHz, q)                              \
+    {                                                                                   \
+        FILTER_DESIGN_Q15(FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz)) \
+            * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)),                           \
+        FILTER_DESIGN_Q15(2.0 * FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz)) \
+            * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)),                           \
+        FILTER_DESIGN_Q15(FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz)) \
+            * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q))                            \
+    }
+
+/**
+ * @brief Initializer of the 3 feed forward coefficients of a high pass biquad
+ */
+#define FILTER_BIQUAD_HIGHPASS_B(cutoffHz, sampleRateHz, q)                             \
+    {                                                                                   \
+        FILTER_DESIGN_Q15(FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)),               \
+        FILTER_DESIGN_Q15(-2.0 * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)),        \
+        FILTER_DESIGN_Q15(FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q))                \
+    }
+
+/**
+ * @brief Initializer of the 2 (negated) feedback coefficients of a low or
+ * high pass biquad
+ */
+#define FILTER_BIQUAD_LOWPASS_A(cutoffHz, sampleRateHz, q)                              \
+    {                                                                                   \
+        FILTER_DESIGN_Q15(-2.0 * (FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz)) - 1.0) \
+            * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q)),                           \
+        FILTER_DESIGN_Q15(-(1.0 - FILTER_BIQUAD_K(cutoffHz, sampleRateHz) / (q)         \
+            + FILTER_DESIGN_SQUARE(FILTER_BIQUAD_K(cutoffHz, sampleRateHz)))            \
+            * FILTER_BIQUAD_NORM(cutoffHz, sampleRateHz, q))                            \
+    }
+
+#define FILTER_BIQUAD_HIGHPASS_A(cutoffHz, sampleRateHz, q)                             \
+    FILTER_BIQUAD_LOWPASS_A(cutoffHz, sampleRateHz, q)
+
+
+/***** TYPES *****************************************************************/
+
+
+/***** PROTOTYPES ************************************************************/
+
+
+#endif
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * @file FixedPoint.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Implementation of the Q15/Q31 fixed-point math library
+ *
+ *
+ *****************************************************************************/
+
+/***** INCLUDES **************************************************************/
+#include "FixedPoint.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#define FIX_RECIPROCAL_ITERATIONS       3               //!< Newton-Raphson steps of the reciprocal
+#define FIX_RECIPROCAL_SEED_OFFSET      3031741621LL    //!< 48 / 17 as Q30 (start value of the reciprocal)
+#define FIX_RECIPROCAL_SEED_SLOPE       2021161080LL    //!< 32 / 17 as Q30
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+static uint32_t fixSqrt64(uint64_t x);
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+Q31_t fixReciprocalQ31(Q31_t x, int32_t* pExponent)
+{
+    int32_t exponent = 32;
+    Q31_t mantissa = FIX_Q31_MAX;
+
+    if (x > 0)
+    {
+        // Normalize to 0.5 .. 1.0, so 1 / x = (0.5 / normalized) * 2^(shift + 1)
+        uint32_t shift = fixCountLeadingZeros((uint32_t)x) - 1;
+        int64_t normalized = (int64_t)x << shift;
+
+        // Newton-Raphson for r = 1 / normalized (Q30), which is 0.5 / normalized as Q31
+        int64_t r = FIX_RECIPROCAL_SEED_OFFSET - ((FIX_RECIPROCAL_SEED_SLOPE * normalized) >> 31);
+
+        for (uint32_t i = 0; i < FIX_RECIPROCAL_ITERATIONS; i++)
+        {
+            int64_t product = (normalized * r) >> 31;
+            r = (r * ((1LL << 31) - product)) >> 30;
+        }
+
+        mantissa = fixSat32(r);
+        exponent = (int32_t)shift + 1;
+    }
+
+    if (pExponent != 0)
+        *pExponent = exponent;
+
+    return mantissa;
+}
+
+Q31_t fixSqrtQ31(Q31_t x)
+{
+    if (x <= 0)
+        return 0;
+
+    return (Q31_t)fixSqrt64((uint64_t)x << 31);
+}
+
+Q15_t fixSqrtQ15(Q15_t x)
+{
+    if (x <= 0)
+        return 0;
+
+    return (Q15_t)fixSqrt64((uint64_t)x << 15);
+}
+
+uint32_t fixSqrtU32(uint32_t x)
+{
+    return fixSqrt64(x);
+}
+
+int32_t fixLinearScale(uint64_t numerator, uint64_t denominator)
+{
+    if (denominator == 0 || numerator >= (1ULL << (63 - FIX_LINEAR_FRAC_BITS)))
+        return INT32_MAX;
+
+    uint64_t scale = ((numerator << FIX_LINEAR_FRAC_BITS) + denominator / 2) / denominator;
+
+    return (scale > INT32_MAX) ? INT32_MAX : (int32_t)scale;
+}
+
+
+/***** PRIVATE FUNCTIONS *****************************************************/
+
+/**
+ * @brief Integer square root (digit by digit, one result bit per step,
+ * without multiplication)
+ *
+ * @param x     Value (< 2^64)
+ *
+ * @return floor(sqrt(x))
+ */
+static uint32_t fixSqrt64(uint64_t x)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (x >= result + bit)
+        {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (uint32_t)result;
+}
@@ -0,0 +1,345 @@
+/******************************************************************************
+ * @file FixedPoint.h
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Header file of the Q15/Q31 fixed-point math library
+ *
+ * @details Q15 values are int16_t with 15 fractional bits (-1.0 .. 1.0 - 2^-15),
+ * Q31 values int32_t with 31 fractional bits. All functions saturate
+ * instead of wrapping around, products are truncated (rounded towards
+ * minus infinity) like the multiplications of the DSP instructions.
+ *
+ * On the Cortex-M4 the inline functions map to the DSP instructions (SSAT,
+ * QADD, QSUB, SMLAD, QADD16, PKHBT, CLZ), the 64bit products compile to
+ * SMULL/SMLAL. On other targets (e.g. the host) portable C versions are
+ * used, which return exactly the same results.
+ *
+ * Linear conversions of integers to a physical unit (e.g. ADC digits to µV)
+ * use a FixLinear_t with a scale factor of FIX_LINEAR_FRAC_BITS fractional
+ * bits. The scale factor is calculated once with fixLinearScale(), each
+ * conversion with fixLinear() is then one SMULL, a shift and an addition.
+ *
+ *
+ *****************************************************************************/
+#ifndef _FIXED_POINT_H_
+#define _FIXED_POINT_H_
+
+/***** INCLUDES **************************************************************/
+#include <stdint.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#endif
+
+/***** CONSTANTS *************************************************************/
+
+
+/***** MACROS ****************************************************************/
+#define FIX_Q15_MAX                     INT16_MAX   //!< Largest Q15 value (1.0 - 2^-15)
+#define FIX_Q15_MIN                     INT16_MIN   //!< Smallest Q15 value (-1.0)
+#define FIX_Q31_MAX                     INT32_MAX   //!< Largest Q31 value (1.0 - 2^-31)
+#define FIX_Q31_MIN                     INT32_MIN   //!< Smallest Q31 value (-1.0)
+
+#define FIX_LINEAR_FRAC_BITS            16          //!< Fractional bits of the scale factor of a FixLinear_t
+
+/**
+ * @brief Converts a constant -1.0 .. 1.0 to Q15 (rounded, 1.0 is saturated)
+ */
+#define FIX_Q15(x)                      ((Q15_t)((x) >= 1.0 ? FIX_Q15_MAX : (x) * 32768.0 + ((x) < 0.0 ? -0.5 : 0.5)))
+
+/**
+ * @brief Converts a constant -1.0 .. 1.0 to Q31 (rounded, 1.0 is saturated)
+ */
+#define FIX_Q31(x)                      ((Q31_t)((x) >= 1.0 ? FIX_Q31_MAX : (x) * 2147483648.0 + ((x) < 0.0 ? -0.5 : 0.5)))
+
+/***** TYPES *****************************************************************/
+
+typedef int16_t Q15_t;                  //!< Fixed-point value with 15 fractional bits
+typedef int32_t Q31_t;                  //!< Fixed-point value with 31 fractional bits
+
+/**
+ * @brief Linear conversion of an integer x to a physical unit:
+ * y = ((x * scale) >> FIX_LINEAR_FRAC_BITS) + offset
+ */
+typedef struct _FixLinear_
+{
+    int32_t scale;                      //!< Scale factor with FIX_LINEAR_FRAC_BITS fractional bits
+    int32_t offset;                     //!< Offset (in the unit of the result)
+} FixLinear_t;
+
+
+/***** PROTOTYPES ************************************************************/
+
+/**
+ * @brief Reciprocal of a positive Q31 value
+ *
+ * The result is split into a mantissa and an exponent, 1 / x = mantissa
+ * * 2^exponent. The mantissa is in the range 0.5 .. 1.0 (1.0 saturated to
+ * FIX_Q31_MAX), the error is max. 2 LSB of the mantissa.
+ *
+ * @param x                 Value (> 0)
+ * @param pExponent         Exponent of the result (1 .. 31), may be 0
+ *
+ * @return Mantissa of the reciprocal (Q31), FIX_Q31_MAX and exponent 32 for
+ * x <= 0
+ */
+Q31_t fixReciprocalQ31(Q31_t x, int32_t* pExponent);
+
+/**
+ * @brief Square root of a Q31 value (rounded down, exact)
+ *
+ * @param x                 Value (>= 0)
+ *
+ * @return Square root (Q31), 0 for negative values
+ */
+Q31_t fixSqrtQ31(Q31_t x);
+
+/**
+ * @brief Square root of a Q15 value (rounded down, exact)
+ *
+ * @param x                 Value (>= 0)
+ *
+ * @return Square root (Q15), 0 for negative values
+ */
+Q15_t fixSqrtQ15(Q15_t x);
+
+/**
+ * @brief Square root of an unsigned integer (rounded down, exact), e.g.
+ * for the RMS of a sum of squares
+ *
+ * @param x                 Value
+ *
+ * @return floor(sqrt(x))
+ */
+uint32_t fixSqrtU32(uint32_t x);
+
+/**
+ * @brief Scale factor numerator / denominator of a FixLinear_t (rounded,
+ * saturated)
+ *
+ * The 64bit division is meant for the calibration, not for each value.
+ *
+ * @param numerator         Numerator (< 2^(63 - FIX_LINEAR_FRAC_BITS))
+ * @param denominator       Denominator (> 0)
+ *
+ * @return numerator / denominator with FIX_LINEAR_FRAC_BITS fractional
+ * bits, INT32_MAX if it does not fit or for denominator = 0
+ */
+int32_t fixLinearScale(uint64_t numerator, uint64_t denominator);
+
+
+/***** INLINE FUNCTIONS ******************************************************/
+
+/**
+ * @brief Saturates a 32bit value to Q15 (SSAT #16)
+ */
+static inline Q15_t fixSat16(int32_t x)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return (Q15_t)__SSAT(x, 16);
+#else
+    if (x > FIX_Q15_MAX)
+        return FIX_Q15_MAX;
+    if (x < FIX_Q15_MIN)
+        return FIX_Q15_MIN;
+
+    return (Q15_t)x;
+#endif
+}
+
+/**
+ * @brief Saturates a 64bit value to Q31
+ */
+static inline Q31_t fixSat32(int64_t x)
+{
+    if (x > FIX_Q31_MAX)
+        return FIX_Q31_MAX;
+    if (x < FIX_Q31_MIN)
+        return FIX_Q31_MIN;
+
+    return (Q31_t)x;
+}
+
+/**
+ * @brief Saturating Q15 addition
+ */
+static inline Q15_t fixAddQ15(Q15_t a, Q15_t b)
+{
+    return fixSat16((int32_t)a + b);
+}
+
+/**
+ * @brief Saturating Q15 subtraction
+ */
+static inline Q15_t fixSubQ15(Q15_t a, Q15_t b)
+{
+    return fixSat16((int32_t)a - b);
+}
+
+/**
+ * @brief Saturating Q31 addition (QADD)
+ */
+static inline Q31_t fixAddQ31(Q31_t a, Q31_t b)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __QADD(a, b);
+#else
+    return fixSat32((int64_t)a + b);
+#endif
+}
+
+/**
+ * @brief Saturating Q31 subtraction (QSUB)
+ */
+static inline Q31_t fixSubQ31(Q31_t a, Q31_t b)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __QSUB(a, b);
+#else
+    return fixSat32((int64_t)a - b);
+#endif
+}
+
+/**
+ * @brief Q15 multiplication (truncated, -1.0 * -1.0 saturates)
+ */
+static inline Q15_t fixMulQ15(Q15_t a, Q15_t b)
+{
+    return fixSat16(((int32_t)a * b) >> 15);
+}
+
+/**
+ * @brief Q31 multiplication (SMULL, truncated, -1.0 * -1.0 saturates)
+ */
+static inline Q31_t fixMulQ31(Q31_t a, Q31_t b)
+{
+    return fixSat32(((int64_t)a * b) >> 31);
+}
+
+/**
+ * @brief Multiplies a Q31 value with an integer (SMULL, saturated), e.g. to
+ * scale a Q31 factor to a physical unit
+ */
+static inline int32_t fixMulQ31Int(Q31_t a, int32_t b)
+{
+    return fixSat32(((int64_t)a * b) >> 31);
+}
+
+/**
+ * @brief Linear conversion of an integer (SMULL, truncated, saturated)
+ *
+ * @return ((x * scale) >> FIX_LINEAR_FRAC_BITS) + offset
+ */
+static inline int32_t fixLinear(const FixLinear_t* pLinear, int32_t x)
+{
+    return fixSat32((((int64_t)x * pLinear->scale) >> FIX_LINEAR_FRAC_BITS) + pLinear->offset);
+}
+
+/**
+ * @brief Q15 multiply-accumulate into a saturating Q30 accumulator
+ * (product + QADD)
+ *
+ * @return acc + a * b (Q30)
+ */
+static inline int32_t fixMacQ15(int32_t acc, Q15_t a, Q15_t b)
+{
+    return fixAddQ31(acc, (int32_t)a * b);
+}
+
+/**
+ * @brief Q31 multiply-accumulate into a 64bit Q62 accumulator (SMLAL)
+ *
+ * @return acc + a * b (Q62)
+ */
+static inline int64_t fixMacQ31(int64_t acc, Q31_t a, Q31_t b)
+{
+    return acc + (int64_t)a * b;
+}
+
+/**
+ * @brief Converts a Q62 accumulator of fixMacQ31() to Q31 (truncated,
+ * saturated)
+ */
+static inline Q31_t fixQ62ToQ31(int64_t acc)
+{
+    return fixSat32(acc >> 31);
+}
+
+/**
+ * @brief Packs two Q15 values into one word, a in the low and b in the
+ * high halfword (PKHBT)
+ */
+static inline uint32_t fixPack16(int32_t a, int32_t b)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __PKHBT(a, b, 16);
+#else
+    return ((uint32_t)a & 0x0000FFFFUL) | (((uint32_t)b << 16) & 0xFFFF0000UL);
+#endif
+}
+
+/**
+ * @brief Dual Q15 multiply-accumulate of packed values (SMLAD)
+ *
+ * @return acc + a.low * b.low + a.high * b.high (wraps around)
+ */
+static inline uint32_t fixDualMacQ15(uint32_t a, uint32_t b, uint32_t acc)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __SMLAD(a, b, acc);
+#else
+    int32_t low = (int32_t)(int16_t)(a & 0xFFFF) * (int16_t)(b & 0xFFFF);
+    int32_t high = (int32_t)(int16_t)(a >> 16) * (int16_t)(b >> 16);
+
+    return acc + (uint32_t)low + (uint32_t)high;
+#endif
+}
+
+/**
+ * @brief Dual saturating Q15 addition of packed values (QADD16)
+ */
+static inline uint32_t fixDualAddQ15(uint32_t a, uint32_t b)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __QADD16(a, b);
+#else
+    uint32_t low = (uint16_t)fixSat16((int32_t)(int16_t)(a & 0xFFFF) + (int16_t)(b & 0xFFFF));
+    uint32_t high = (uint16_t)fixSat16((int32_t)(int16_t)(a >> 16) + (int16_t)(b >> 16));
+
+    return low | (high << 16);
+#endif
+}
+
+/**
+ * @brief Number of leading zero bits (CLZ)
+ *
+ * @return 0 .. 32 (32 for x = 0)
+ */
+static inline uint32_t fixCountLeadingZeros(uint32_t x)
+{
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __CLZ(x);
+#else
+    uint32_t count = 0;
+
+    if (x == 0)
+        return 32;
+
+    while ((x & 0x80000000UL) == 0)
+    {
+        x <<= 1;
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+
+#endif
@@ -23,6 +23,7 @@
 #include "Util/Global.h"
 #include "Util/Log/printf.h"
 #include "Util/Log/LogOutput.h"
+#include "Util/Filter/FilterDesign.h"
 
 #include "UARTModule.h"
 #include "ButtonModule.h"
@@ -30,15 +31,27 @@
 #include "DisplayModule.h"
 #include "ADCModule.h"
 #include "TimerModule.h"
+#include "FMACModule.h"
 #include "Scheduler.h"
+#include "Kernel.h"
+#include "TicklessIdle.h"
+#include "Coroutine.h"
 
 #include "GlobalObjects.h"
+#include "AppTasks.h"
+#include "AppSchedule.h"
 
 
 /***** PRIVATE CONSTANTS *****************************************************/
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define TASK_STACK_WORDS        256     //!< Stack size (32bit words) of each task of the preemptive kernel
+#define ISR_WORK_QUEUE_SIZE     16      //!< Number of work items in the queue for the ADC/DMA interrupts
+#define ADC_FRAME_BUFFER_SIZE   16      //!< Number of ADC frames buffered for the task context (4 DMA blocks)
+#define PHASE_SPREAD_DELAY      1000    //!< Time (ms) the task runtimes are measured before the phases are spread
+#define POT_FILTER_CUTOFF_HZ    2.0     //!< Cutoff frequency of the EMA filter and of the biquad of the potentiometer input
+#define POT_FILTER_SCALING      1024    //!< Scaling factor of the alpha of the potentiometer filter
 
 
 /***** PRIVATE TYPES *********************************************************/
@@ -46,11 +59,54 @@
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 static int32_t initializePeripherals();
+static void logSchedulerStats();
+static void ledSequence();
+void taskDemo25ms();                    // Not static, also referenced by the generated frame table (AppSchedule.c)
+#ifndef OS_KERNEL_PREEMPTIVE
+static void workAdcConversion(uint32_t conversionCount);
+#endif
 
 
 /***** PRIVATE VARIABLES *****************************************************/
+static const char* gTaskNames[] = { "10ms", "50ms", "250ms", "demo" };     // Names of the tasks for the statistics output
+
+// Oversampling of all channels by 256 with 16bit results, for a higher
+// resolution of the potentiometer inputs
+static const ADC_Acquisition_t gAdcAcquisition = { 256, 4, 0, 0 };
+
+// Alpha of the potentiometer filter, calculated at build time for the default
+// ADC trigger rate. The application never changes the rate, a call of
+// adcSetSampleRate() would have to recompute it (and the biquad coefficients)
+static const int32_t gPotFilterAlpha = FILTER_EMA_ALPHA(POT_FILTER_CUTOFF_HZ, TIMER_SAMPLE_RATE_HZ, POT_FILTER_SCALING);
+
+static int gGlobalCounter = 0;          // Counter shown on the 7-segment display
+static uint8_t gLeftDisplay = 0;        // Flag whether the left or right digit is updated
+static TaskContext gLedSequence = TASK_CONTEXT_INIT(HAL_GetTick);  // Coroutine state of the LED sequence
+
+#ifndef OS_KERNEL_PREEMPTIVE
 static Scheduler gScheduler;            // Global Scheduler instance
 
+static WorkItem gIsrWorkItems[ISR_WORK_QUEUE_SIZE];     // Buffer for the deferred work of the ADC/DMA interrupts
+static WorkQueue gIsrWorkQueue;         // Deferred work queue for the ADC/DMA interrupts
+static uint32_t gAdcConversionCount;    // Last frame processed in task context
+static ADC_Frame_t gAdcFrames[ADC_FRAME_BUFFER_SIZE];   // Buffer for the ADC frames passed to the task context
+static uint32_t gAdcFrameCount;         // Number of ADC frames read in task context
+static uint32_t gAdcLastTimestamp;      // Trigger timestamp of the last ADC frame
+static uint32_t gAdcIntervalMin = UINT32_MAX;   // Min. time between two ADC frames in timestamp ticks
+static uint32_t gAdcIntervalMax;        // Max. time between two ADC frames in timestamp ticks
+
+// Biquad low pass of the potentiometer input, designed at build time for the default ADC trigger rate
+static const int16_t gPotBiquadB[3] = FILTER_BIQUAD_LOWPASS_B(POT_FILTER_CUTOFF_HZ, TIMER_SAMPLE_RATE_HZ, FILTER_BIQUAD_Q_BUTTERWORTH);
+static const int16_t gPotBiquadA[2] = FILTER_BIQUAD_LOWPASS_A(POT_FILTER_CUTOFF_HZ, TIMER_SAMPLE_RATE_HZ, FILTER_BIQUAD_Q_BUTTERWORTH);
+static FilterQ15Data_t gPotBiquad;      // Biquad of the potentiometer input (FMAC backend if available)
+static int16_t gPotBiquadOutput;        // Last output of the potentiometer biquad (Q15 around mid scale)
+#else
+static uint32_t gStackTask10ms[TASK_STACK_WORDS] __attribute__((aligned(8)));     // Stack for 10ms task
+static uint32_t gStackTask50ms[TASK_STACK_WORDS] __attribute__((aligned(8)));     // Stack for 50ms task
+static uint32_t gStackTask250ms[TASK_STACK_WORDS] __attribute__((aligned(8)));    // Stack for 250ms task
+static uint32_t gStackTaskDemo[TASK_STACK_WORDS] __attribute__((aligned(8)));     // Stack for demo task
+#endif
+
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
@@ -69,76 +125,162 @@ int main(void)
     // Initialize Peripherals
     initializePeripherals();
 
-    // Initialize Scheduler
-    schedInitialize(&gScheduler);
-
-    int globalCounter = 0;
-    uint8_t left = 0;
+#ifdef OS_KERNEL_PREEMPTIVE
+    // Register the cyclic application tasks at the preemptive kernel,
+    // the shortest period gets the highest priority. The rest of main()
+    // continues as idle task
+    kernelInitialize();
+    kernelAddTask(taskApp10ms, 10, 0, 0, gStackTask10ms, TASK_STACK_WORDS);
+    kernelAddTask(taskApp50ms, 50, 0, 1, gStackTask50ms, TASK_STACK_WORDS);
+    kernelAddTask(taskApp250ms, 250, 0, 2, gStackTask250ms, TASK_STACK_WORDS);
+    kernelAddTask(taskDemo25ms, 25, 0, 3, gStackTaskDemo, TASK_STACK_WORDS);
+    kernelStart();
 
     while (1)
     {
-        // Read to buttons
-        Button_Status_t but1 = buttonGetButtonStatus(BTN_SW1);
-        Button_Status_t but2 = buttonGetButtonStatus(BTN_SW2);
-        Button_Status_t but3 = buttonGetButtonStatus(BTN_B1);
+        // Nothing to do for the idle task, wait for the next interrupt
+        __WFI();
+    }
+#else
+    // Initialize Scheduler and register the cyclic application tasks
+    // The DWT cycle counter is used to measure the runtime of the tasks
+    SystemCycleCounter_Init();
+    gScheduler.pGetHALTick = HAL_GetTick;
+    gScheduler.pGetCycleCount = SystemCycleCounter_Get;
+    schedInitialize(&gScheduler);
 
-        // Read the POT1 input from ADC
-        int adcValue = adcReadChannel(ADC_INPUT0);
+#ifdef OS_SCHED_CYCLIC_EXECUTIVE
+    // Static schedule generated from src/App/AppSchedule.json (make schedule)
+    schedSetFrameTable(&gScheduler, &gAppFrameTable);
+#else
+    schedAddTask(&gScheduler, taskApp10ms, 10, 0);
+    schedAddTask(&gScheduler, taskApp50ms, 50, 0);
+    schedAddTask(&gScheduler, taskApp250ms, 250, 0);
+    schedAddTask(&gScheduler, taskDemo25ms, 25, 0);
+
+    // All tasks start with phase 0, until their runtime has been measured
+    uint32_t spreadTick = HAL_GetTick() + PHASE_SPREAD_DELAY;
+    bool phasesSpread = false;
+#endif
+
+    // The ADC/DMA interrupts only post a work item, which is executed by the scheduler
+    workqInitialize(&gIsrWorkQueue, gIsrWorkItems, ISR_WORK_QUEUE_SIZE);
+    schedAddWorkQueue(&gScheduler, &gIsrWorkQueue);
+    adcSetFrameBuffer(gAdcFrames, ADC_FRAME_BUFFER_SIZE);
+    adcSetConversionWork(&gIsrWorkQueue, workAdcConversion);
+
+    // Sleep between the tasks instead of polling the scheduler
+    idleInitialize();
 
-        // If SW1 is pressed, print some debug message on the terminal
-        if (but1 == BUTTON_PRESSED)
-        {
-            // Toggle all LEDs to the their functionality (Toggle frequency depends on HAL_Delay at end of loop)
-            ledToggleLED(LED0);
-            HAL_Delay(25);
-            ledToggleLED(LED1);
-            HAL_Delay(25);
-            ledToggleLED(LED2);
-            HAL_Delay(25);
-            ledToggleLED(LED3);
-            HAL_Delay(25);
-            ledToggleLED(LED4);
-            HAL_Delay(25);
-        }
+    while (1)
+    {
+        // Execute all tasks which are due
+        schedCycle(&gScheduler);
 
-        // If SW2 is pressed, print the ADC digit value on the terminal
-        if (but2 == BUTTON_PRESSED)
+#ifndef OS_SCHED_CYCLIC_EXECUTIVE
+        // Once the runtime of the tasks is known, assign phase offsets so
+        // the tasks are no longer released all at the same tick
+        if (phasesSpread == false && (int32_t)(HAL_GetTick() - spreadTick) >= 0)
         {
-        	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_RESET);
+            schedSpreadPhases(&gScheduler);
+            schedResetTaskStats(&gScheduler);
+            phasesSpread = true;
         }
-        else
+#endif
+
+        // Sleep until the next task is due (or an interrupt occurs). The
+        // interrupts are disabled during the check, so work posted by an
+        // ISR right before going to sleep still wakes up the core
+        uint32_t nextRelease = 0;
+        __disable_irq();
+        if (schedHasPendingWork(&gScheduler) == false
+            && schedGetNextRelease(&gScheduler, &nextRelease) == SCHED_ERR_OK)
         {
-        	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_SET);
+            idleSleepUntil(nextRelease);
         }
+        __enable_irq();
+    }
+#endif
+}
 
-        if (but3 == BUTTON_PRESSED)
-        {
-        	outputLogf("ADC Val: %d\n\r", adcValue);
-        }
+/***** PRIVATE FUNCTIONS *****************************************************/
 
-        globalCounter++;
-        if (globalCounter > 99)
-        {
-            globalCounter = 0;
-        }
+/**
+ * @brief Cyclic demo task (25ms) which reads the buttons and the ADC and
+ * updates the LEDs, the beeper and the 7-segment display
+ */
+void taskDemo25ms()
+{
+    // Read to buttons
+    Button_Status_t but2 = buttonGetButtonStatus(BTN_SW2);
+    Button_Status_t but3 = buttonGetButtonStatus(BTN_B1);
 
-        if (left == 1)
-        {
-            displayShowDigit(LEFT_DISPLAY, (globalCounter / 10));
-        }
-        else
-        {
-            displayShowDigit(RIGHT_DISPLAY, (globalCounter % 10));
-        }
+    // Follow the supply voltage with the VREFINT channel, then read the POT1 input from ADC
+    adcUpdateCalibration();
+    int adcValue = adcReadChannel(ADC_INPUT0);
+
+    // If SW1 is pressed, toggle all LEDs one after the other (the sequence
+    // continues on the next task calls, so the other tasks are not blocked)
+    ledSequence();
+
+    // If SW2 is pressed, print the ADC digit value on the terminal
+    if (but2 == BUTTON_PRESSED)
+    {
+    	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_RESET);
+    }
+    else
+    {
+    	HAL_GPIO_WritePin(BEEP_GPIO_PORT, BEEP_PIN, GPIO_PIN_SET);
+    }
+
+    if (but3 == BUTTON_PRESSED)
+    {
+    	outputLogf("ADC Val: %d\n\r", adcValue);
+    	outputLogf("VDDA: %ld uV Temp: %ld mC\n\r", adcGetSupplyVoltage(), adcReadChannel(ADC_TEMP));
+    	logSchedulerStats();
+    }
 
-        left = !left;
+    gGlobalCounter++;
+    if (gGlobalCounter > 99)
+    {
+        gGlobalCounter = 0;
+    }
 
-        // Remove this HAL_Delay as soon as there is a Scheduler used
-        HAL_Delay(25);
+    if (gLeftDisplay == 1)
+    {
+        displayShowDigit(LEFT_DISPLAY, (gGlobalCounter / 10));
+    }
+    else
+    {
+        displayShowDigit(RIGHT_DISPLAY, (gGlobalCounter % 10));
     }
+
+    gLeftDisplay = !gLeftDisplay;
 }
 
-/***** PRIVATE FUNCTIONS *****************************************************/
+/**
+ * @brief Coroutine which toggles all LEDs one after the other with 25ms
+ * delay, started whenever SW1 is pressed
+ */
+static void ledSequence()
+{
+    TASK_BEGIN(&gLedSequence);
+
+    TASK_YIELD_UNTIL(&gLedSequence, buttonGetButtonStatus(BTN_SW1) == BUTTON_PRESSED);
+
+    ledToggleLED(LED0);
+    TASK_SLEEP(&gLedSequence, 25);
+    ledToggleLED(LED1);
+    TASK_SLEEP(&gLedSequence, 25);
+    ledToggleLED(LED2);
+    TASK_SLEEP(&gLedSequence, 25);
+    ledToggleLED(LED3);
+    TASK_SLEEP(&gLedSequence, 25);
+    ledToggleLED(LED4);
+    TASK_SLEEP(&gLedSequence, 25);
+
+    TASK_END(&gLedSequence);
+}
 
 /**
  * @brief Initializes the used peripherals like GPIO,
@@ -160,7 +302,103 @@ static int32_t initializePeripherals()
 
     // Initialize Timer, DMA and ADC for sensor measurements
     timerInitialize();
-    adcInitialize();
+    adcInitialize(&gAdcAcquisition);
+    adcSetChannelFilter(ADC_INPUT0, POT_FILTER_SCALING, gPotFilterAlpha);
+    adcSetChannelFilter(ADC_VREF, POT_FILTER_SCALING, gPotFilterAlpha);
+    adcSetChannelFilter(ADC_TEMP, POT_FILTER_SCALING, gPotFilterAlpha);
+
+#ifndef OS_KERNEL_PREEMPTIVE
+    // The potentiometer blocks are filtered on the FMAC, the software
+    // backend is the fallback if the FMAC can't be initialized
+    FilterQ15Config_t potBiquadConfig = { FILTER_Q15_IIR, gPotBiquadB, gPotBiquadA, 3, 2, FILTER_BIQUAD_GAIN };
+    filterInitQ15(&gPotBiquad, &potBiquadConfig, (fmacInitialize() == FMAC_ERR_OK) ? fmacFilterQ15 : 0);
+#endif
 
     return ERROR_OK;
 }
+
+/**
+ * @brief Outputs the runtime statistics of all scheduler tasks on the UART
+ *
+ * Execution times are given in CPU cycles, the release jitter in ms
+ */
+static void logSchedulerStats()
+{
+#ifdef OS_KERNEL_PREEMPTIVE
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        outputLogf("Task %s: ovr %lu\n\r", gTaskNames[i], kernelGetOverrunCount(i));
+    }
+#else
+    for (int32_t i = 0; i < gScheduler.taskCount; i++)
+    {
+        SchedulerTaskStats stats;
+        schedGetTaskStats(&gScheduler, i, &stats);
+
+        outputLogf("Task %s: run %lu ovr %lu mis %lu skp %lu exec %lu/%lu/%lu jit %lu/%lu/%lu\n\r",
+            gTaskNames[i], stats.runCount, stats.overrunCount, stats.missedCount, stats.skippedCount,
+            stats.execCyclesMin, stats.execCyclesAvg, stats.execCyclesMax,
+            stats.jitterMin, stats.jitterAvg, stats.jitterMax);
+    }
+
+    if (gScheduler.pFrameTable != 0)
+    {
+        outputLogf("Frame overruns: %lu\n\r", gScheduler.frameOverrunCount);
+    }
+
+    ADC_Statistics_t adcStats;
+    adcGetStatistics(&adcStats);
+
+    outputLogf("ADC conversions: %lu frames read: %lu dropped work: %lu\n\r", gAdcConversionCount, gAdcFrameCount,
+        gIsrWorkQueue.overflowCount);
+    outputLogf("ADC blocks: %lu frame ovr: %lu dma ovr: %lu adc ovr: %lu\n\r", adcStats.blockCount,
+        adcStats.frameOverflowCount, adcStats.dmaOverrunCount, adcStats.adcOverrunCount);
+    outputLogf("ADC frame interval: %lu/%lu us\n\r", gAdcIntervalMin, gAdcIntervalMax);
+    outputLogf("Pot biquad: %ld\n\r", ((int32_t)gPotBiquadOutput + 32768) >> (16 - adcGetResolution()));
+#endif
+}
+
+#ifndef OS_KERNEL_PREEMPTIVE
+/**
+ * @brief Deferred work of the ADC DMA block interrupt, reads all frames
+ * of the block and filters the potentiometer samples of the block with
+ * the biquad (one FMAC block per DMA block)
+ *
+ * @param conversionCount   Running number of the last frame of the block
+ */
+static void workAdcConversion(uint32_t conversionCount)
+{
+    ADC_Frame_t frames[ADC_DMA_BLOCK_FRAMES];
+    int16_t potSamples[ADC_DMA_BLOCK_FRAMES];
+    int32_t potShift = 16 - adcGetResolution();
+    uint32_t count;
+
+    gAdcConversionCount = conversionCount;
+
+    // Every frame of the DMA block is available here, not only the last one
+    while ((count = adcReadFrames(frames, ADC_DMA_BLOCK_FRAMES)) > 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            // The timestamps are latched by the trigger, so the interval is exact
+            uint32_t interval = frames[i].timestamp - gAdcLastTimestamp;
+
+            if (gAdcFrameCount > 0 && interval < gAdcIntervalMin)
+                gAdcIntervalMin = interval;
+            if (gAdcFrameCount > 0 && interval > gAdcIntervalMax)
+                gAdcIntervalMax = interval;
+
+            gAdcLastTimestamp = frames[i].timestamp;
+            gAdcFrameCount++;
+
+            // Unsigned digits to Q15 around mid scale
+            potSamples[i] = (int16_t)(((int32_t)frames[i].value[ADC_INPUT0] << potShift) - 32768);
+        }
+
+        if (filterQ15Block(&gPotBiquad, potSamples, potSamples, count) == FILTER_ERR_OK)
+        {
+            gPotBiquadOutput = potSamples[count - 1];
+        }
+    }
+}
+#endif
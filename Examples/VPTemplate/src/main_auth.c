@@ -31,6 +31,7 @@
 #include "ADCModule.h"
 #include "TimerModule.h"
 #include "Scheduler.h"
+#include "Coroutine.h"
 
 #include "GlobalObjects.h"
 
@@ -39,6 +40,7 @@
 
 
 /***** PRIVATE MACROS ********************************************************/
+#define COMMAND_LENGTH          2       //!< Length of a command received on the UART
 
 
 /***** PRIVATE TYPES *********************************************************/
@@ -46,11 +48,18 @@
 
 /***** PRIVATE PROTOTYPES ****************************************************/
 static int32_t initializePeripherals();
+static void taskLedSequence();
+static void taskUartCommand();
 
 
 /***** PRIVATE VARIABLES *****************************************************/
 static Scheduler gScheduler;            // Global Scheduler instance
 
+static TaskContext gLedSequence = TASK_CONTEXT_INIT(HAL_GetTick);  // Coroutine state of the LED sequence
+static TaskContext gUartCommand = TASK_CONTEXT_INIT(HAL_GetTick);  // Coroutine state of the UART command receiver
+static uint8_t gCommand[COMMAND_LENGTH];                            // Received command
+static int32_t gCommandLength;                                      // Number of received bytes of the command
+
 
 /***** PUBLIC FUNCTIONS ******************************************************/
 
@@ -69,37 +78,73 @@ int main(void)
     initializePeripherals();
 
     // Initialize Scheduler
+    gScheduler.pGetHALTick = HAL_GetTick;
     schedInitialize(&gScheduler);
 
+    // Both sequences are coroutines, so they run interleaved. The UART is
+    // polled every tick to keep up with the RX FIFO
+    schedAddTask(&gScheduler, taskLedSequence, 10, 0);
+    schedAddTask(&gScheduler, taskUartCommand, 1, 0);
+
     while (1)
     {
-        // Toggle all LEDs to the their functionality (Toggle frequency depends on HAL_Delay at end of loop)
-        ledToggleLED(LED0);
-        HAL_Delay(100);
-        ledToggleLED(LED1);
-        HAL_Delay(100);
-        ledToggleLED(LED2);
-        HAL_Delay(100);
-        ledToggleLED(LED3);
-        HAL_Delay(100);
-        ledToggleLED(LED4);
-        HAL_Delay(100);
-
-        uint8_t buf[10];
-        uartReceiveData(buf, 2);
-        if (buf[0] == 'X' && buf[1] == '\r')
-        {
-            displayShowDigit(RIGHT_DISPLAY, DIGIT_DASH);
-        }
-        else
-        {
-            displayShowDigit(RIGHT_DISPLAY, DIGIT_OFF);
-        }
+        schedCycle(&gScheduler);
     }
 }
 
 /***** PRIVATE FUNCTIONS *****************************************************/
 
+/**
+ * @brief Cyclic task (coroutine) which toggles all LEDs one after the
+ * other with 100ms delay
+ */
+static void taskLedSequence()
+{
+    TASK_BEGIN(&gLedSequence);
+
+    ledToggleLED(LED0);
+    TASK_SLEEP(&gLedSequence, 100);
+    ledToggleLED(LED1);
+    TASK_SLEEP(&gLedSequence, 100);
+    ledToggleLED(LED2);
+    TASK_SLEEP(&gLedSequence, 100);
+    ledToggleLED(LED3);
+    TASK_SLEEP(&gLedSequence, 100);
+    ledToggleLED(LED4);
+    TASK_SLEEP(&gLedSequence, 100);
+
+    TASK_END(&gLedSequence);
+}
+
+/**
+ * @brief Cyclic task (coroutine) which waits for a command on the UART
+ * and shows a dash on the display if "X\r" has been received
+ */
+static void taskUartCommand()
+{
+    int8_t hasData = 0;
+
+    TASK_BEGIN(&gUartCommand);
+
+    for (gCommandLength = 0; gCommandLength < COMMAND_LENGTH; gCommandLength++)
+    {
+        // Only read if a byte is available, so the receive doesn't block
+        TASK_YIELD_UNTIL(&gUartCommand, uartHasData(&hasData) == UART_ERR_OK && hasData == 1);
+        uartReceiveData(&gCommand[gCommandLength], 1);
+    }
+
+    if (gCommand[0] == 'X' && gCommand[1] == '\r')
+    {
+        displayShowDigit(RIGHT_DISPLAY, DIGIT_DASH);
+    }
+    else
+    {
+        displayShowDigit(RIGHT_DISPLAY, DIGIT_OFF);
+    }
+
+    TASK_END(&gUartCommand);
+}
+
 /**
  * @brief Initializes the used peripherals like GPIO,
  * ADC, DMA and Timer Interrupts
@@ -120,7 +165,7 @@ static int32_t initializePeripherals()
 
     // Initialize Timer, DMA and ADC for sensor measurements
     timerInitialize();
-    adcInitialize();
+    adcInitialize(0);
 
     return ERROR_OK;
 }
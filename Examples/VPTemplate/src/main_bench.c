@@ -0,0 +1,119 @@
+/******************************************************************************
+ * @file main_bench.c
+ *
+ * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+ * @date   03.01.2026
+ *
+ * @copyright Copyright (c) 2026
+ *
+ ******************************************************************************
+ *
+ * @brief Main file of the filter benchmark firmware
+ *
+ * @details Runs all Filter library kernels once after reset (with disabled
+ * interrupts) and prints the cycles per sample and the output checksums on
+ * the debug UART. Afterwards the Q15 kernels are run with the FMAC backend
+ * (with enabled interrupts, the FMAC DMA completes the blocks) and the
+ * number of output samples which differ from the software backend is
+ * printed. Build it with "make bench" for one profile or with
+ * "make bench-all" for all profiles.
+ *
+ *
+ *****************************************************************************/
+
+
+/***** INCLUDES **************************************************************/
+#include "stm32g4xx_hal.h"
+#include "System.h"
+
+#include "Util/Global.h"
+#include "Util/Log/LogOutput.h"
+
+#include "UARTModule.h"
+#include "FMACModule.h"
+
+#include "Bench/FilterBenchmark.h"
+
+
+/***** PRIVATE CONSTANTS *****************************************************/
+
+
+/***** PRIVATE MACROS ********************************************************/
+#ifndef BUILD_PROFILE
+#define BUILD_PROFILE           "unknown"       //!< Name of the build profile (set by the Makefile)
+#endif
+
+
+/***** PRIVATE TYPES *********************************************************/
+
+
+/***** PRIVATE PROTOTYPES ****************************************************/
+
+
+/***** PRIVATE VARIABLES *****************************************************/
+static FilterBenchResult gResults[FILTER_BENCH_MAX_KERNELS];   // Results of the kernels
+static FilterBenchResult gFMACResults[FILTER_BENCH_MAX_KERNELS]; // Results of the Q15 kernels with the FMAC backend
+
+
+/***** PUBLIC FUNCTIONS ******************************************************/
+
+
+/**
+ * @brief Main function of the benchmark
+ */
+int main(void)
+{
+    // Initialize the HAL
+    HAL_Init();
+
+    SystemClock_Config();
+
+    // Initialize UART used for the results
+    uartInitialize(115200);
+    SystemCycleCounter_Init();
+
+    // No interrupt (SysTick, UART) must disturb the measurement
+    __disable_irq();
+    uint32_t resultCount = filterBenchRun(SystemCycleCounter_Get, gResults, FILTER_BENCH_MAX_KERNELS);
+    __enable_irq();
+
+    outputLogf("Filter benchmark, profile %s, %d samples\r\n", BUILD_PROFILE, FILTER_BENCH_SAMPLES);
+    outputLogf("%-12s %10s %10s %10s\r\n", "kernel", "cycles", "cyc/smp", "checksum");
+
+    for (uint32_t i = 0; i < resultCount; i++)
+    {
+        outputLogf("%-12s %10lu %7lu.%02lu   %08lx\r\n", gResults[i].pName,
+            (unsigned long)gResults[i].cycles,
+            (unsigned long)(gResults[i].cyclesPerSample100 / 100),
+            (unsigned long)(gResults[i].cyclesPerSample100 % 100),
+            (unsigned long)gResults[i].checksum);
+    }
+
+    // The FMAC backend waits for the DMA interrupt of each block
+    uint32_t fmacCount = 0;
+    if (fmacInitialize() == FMAC_ERR_OK)
+    {
+        fmacCount = filterBenchRunQ15Backend(SystemCycleCounter_Get, fmacFilterQ15, gFMACResults,
+                                             FILTER_BENCH_MAX_KERNELS);
+    }
+
+    outputLogf("FMAC backend\r\n");
+    outputLogf("%-12s %10s %10s %10s %6s\r\n", "kernel", "cycles", "cyc/smp", "checksum", "diff");
+
+    for (uint32_t i = 0; i < fmacCount; i++)
+    {
+        outputLogf("%-12s %10lu %7lu.%02lu   %08lx %6lu\r\n", gFMACResults[i].pName,
+            (unsigned long)gFMACResults[i].cycles,
+            (unsigned long)(gFMACResults[i].cyclesPerSample100 / 100),
+            (unsigned long)(gFMACResults[i].cyclesPerSample100 % 100),
+            (unsigned long)gFMACResults[i].checksum,
+            (unsigned long)gFMACResults[i].mismatchCount);
+    }
+
+    while (1)
+    {
+        __WFI();
+    }
+}
+
+/***** PRIVATE FUNCTIONS *****************************************************/
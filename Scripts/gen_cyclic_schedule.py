@@ -0,0 +1,267 @@
+###############################################################################
+# @file gen_cyclic_schedule.py
+#
+# @author Andreas Schmidt (a.v.schmidt81@googlemail.com)
+# @date   03.01.2026
+#
+# @copyright Copyright (c) 2026
+#
+###############################################################################
+#
+# @brief Generates the static frame table of a cyclic executive from a task
+# list. The task list is a JSON file with the period (in HAL ticks) and the
+# WCET budget (in microseconds) of each task:
+#
+#   {
+#       "table": "gAppFrameTable",
+#       "tickMicroseconds": 1000,
+#       "tasks": [
+#           { "function": "taskApp10ms", "period": 10, "wcet": 200 },
+#           ...
+#       ]
+#   }
+#
+# The hyperperiod is the LCM of all periods. The minor frame is the largest
+# divisor of the hyperperiod which fulfills the classic frame conditions
+# (frame >= max. WCET, 2 * frame - gcd(frame, period) <= period), so every
+# release has a complete frame between its release and its deadline (end of
+# the period). Each job of the hyperperiod is then assigned to the frame with
+# the lowest load inside its window, which keeps the worst case frame load
+# small. If a job doesn't fit into any frame, the next smaller frame is tried.
+#
+# The output is a C file with the constant frame table (placed in flash) and
+# a header file with its declaration. The worst case load of every frame is
+# written as comment into the table.
+#
+#
+###############################################################################
+import argparse
+import json
+import math
+import os
+import sys
+
+
+def lcm(a, b):
+    return a * b // math.gcd(a, b)
+
+
+def frameCandidates(tasks, hyperperiod, tickMicroseconds):
+    """Returns all valid minor frame lengths (in ticks), largest first."""
+    maxWcet = max(task['wcet'] for task in tasks)
+    candidates = []
+
+    for frame in range(hyperperiod, 0, -1):
+        if hyperperiod % frame != 0:
+            continue
+        if frame * tickMicroseconds < maxWcet:
+            continue
+        if all(2 * frame - math.gcd(frame, task['period']) <= task['period'] for task in tasks):
+            candidates.append(frame)
+
+    return candidates
+
+
+def assignJobs(tasks, hyperperiod, frame, tickMicroseconds):
+    """Assigns all jobs of the hyperperiod to the frames.
+
+    Returns the list of task indices per frame or None if not feasible.
+    """
+    frameCount = hyperperiod // frame
+    capacity = frame * tickMicroseconds
+    loads = [0] * frameCount
+    frames = [[] for i in range(frameCount)]
+
+    # Every job is (release, deadline, task index)
+    jobs = []
+    for index, task in enumerate(tasks):
+        for release in range(0, hyperperiod, task['period']):
+            jobs.append((release, release + task['period'], index))
+
+    # Place the jobs with the fewest possible frames and the largest WCET first
+    jobs.sort(key=lambda job: (tasks[job[2]]['period'], -tasks[job[2]]['wcet'], job[0]))
+
+    for release, deadline, index in jobs:
+        wcet = tasks[index]['wcet']
+
+        # Frames which start after the release and end before the deadline
+        first = -(-release // frame)
+        last = deadline // frame
+        eligible = [i for i in range(first, last) if loads[i] + wcet <= capacity]
+        if len(eligible) == 0:
+            return None
+
+        # Use the frame with the lowest load to minimize the worst case frame
+        best = min(eligible, key=lambda i: (loads[i], i))
+        loads[best] += wcet
+        frames[best].append(index)
+
+    # Execute the tasks of a frame in order of their period (shortest first)
+    for frameTasks in frames:
+        frameTasks.sort(key=lambda index: (tasks[index]['period'], index))
+
+    return frames
+
+
+def writeSource(fileName, headerName, config, tasks, frame, frames, inputName):
+    tickMicroseconds = config['tickMicroseconds']
+    tableName = config['table']
+    capacity = frame * tickMicroseconds
+
+    lines = []
+    lines.append('/******************************************************************************')
+    lines.append(' * @file %s' % os.path.basename(fileName))
+    lines.append(' *')
+    lines.append(' * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)')
+    lines.append(' * @date   03.01.2026')
+    lines.append(' *')
+    lines.append(' * @copyright Copyright (c) 2026')
+    lines.append(' *')
+    lines.append(' ******************************************************************************')
+    lines.append(' *')
+    lines.append(' * @brief Static frame table of the cyclic executive')
+    lines.append(' *')
+    lines.append(' * @details Generated by Scripts/gen_cyclic_schedule.py from %s,' % os.path.basename(inputName))
+    lines.append(' * DO NOT EDIT. Hyperperiod %d ticks, minor frame %d ticks (%d us).' % (frame * len(frames), frame, capacity))
+    lines.append(' *')
+    lines.append(' *')
+    lines.append(' *****************************************************************************/')
+    lines.append('')
+    lines.append('')
+    lines.append('/***** INCLUDES **************************************************************/')
+    lines.append('#include "%s"' % os.path.basename(headerName))
+    lines.append('')
+    lines.append('')
+    lines.append('/***** PRIVATE PROTOTYPES ****************************************************/')
+    for task in tasks:
+        lines.append('void %s(void);' % task['function'])
+    lines.append('')
+    lines.append('')
+    lines.append('/***** PRIVATE VARIABLES *****************************************************/')
+    lines.append('')
+    lines.append('/**')
+    lines.append(' * @brief Tasks of all frames in order of execution')
+    lines.append(' */')
+    lines.append('static const CyclicFunction gFrameTasks[] =')
+    lines.append('{')
+    for frameIndex, frameTasks in enumerate(frames):
+        load = sum(tasks[index]['wcet'] for index in frameTasks)
+        lines.append('    // Frame %d @ %d: %d/%d us' % (frameIndex, frameIndex * frame, load, capacity))
+        for index in frameTasks:
+            lines.append('    %s,' % tasks[index]['function'])
+    lines.append('};')
+    lines.append('')
+    lines.append('/**')
+    lines.append(' * @brief Index of the first task of each frame in gFrameTasks')
+    lines.append(' */')
+    lines.append('static const uint16_t gFrameStart[] =')
+    lines.append('{')
+    start = 0
+    starts = []
+    for frameTasks in frames:
+        starts.append(start)
+        start += len(frameTasks)
+    starts.append(start)
+    for i in range(0, len(starts), 10):
+        lines.append('    ' + ' '.join('%d,' % value for value in starts[i:i + 10]))
+    lines.append('};')
+    lines.append('')
+    lines.append('')
+    lines.append('/***** PUBLIC VARIABLES ******************************************************/')
+    lines.append('const SchedulerFrameTable %s =' % tableName)
+    lines.append('{')
+    lines.append('    .minorFrame     = %d,' % frame)
+    lines.append('    .frameCount     = %d,' % len(frames))
+    lines.append('    .pTasks         = gFrameTasks,')
+    lines.append('    .pFrameStart    = gFrameStart,')
+    lines.append('};')
+
+    with open(fileName, mode='w') as file:
+        file.write('\n'.join(lines) + '\n')
+
+
+def writeHeader(fileName, config, frame, frames):
+    guard = '_%s_H_' % os.path.splitext(os.path.basename(fileName))[0].upper()
+
+    lines = []
+    lines.append('/******************************************************************************')
+    lines.append(' * @file %s' % os.path.basename(fileName))
+    lines.append(' *')
+    lines.append(' * @author Andreas Schmidt (a.v.schmidt81@googlemail.com)')
+    lines.append(' * @date   03.01.2026')
+    lines.append(' *')
+    lines.append(' * @copyright Copyright (c) 2026')
+    lines.append(' *')
+    lines.append(' ******************************************************************************')
+    lines.append(' *')
+    lines.append(' * @brief Header File for the static frame table of the cyclic executive')
+    lines.append(' *')
+    lines.append(' * @details Generated by Scripts/gen_cyclic_schedule.py, DO NOT EDIT.')
+    lines.append(' *')
+    lines.append(' *')
+    lines.append(' *****************************************************************************/')
+    lines.append('#ifndef %s' % guard)
+    lines.append('#define %s' % guard)
+    lines.append('')
+    lines.append('')
+    lines.append('/***** INCLUDES **************************************************************/')
+    lines.append('#include "Scheduler.h"')
+    lines.append('')
+    lines.append('/***** CONSTANTS *************************************************************/')
+    lines.append('extern const SchedulerFrameTable %s;' % config['table'])
+    lines.append('')
+    lines.append('')
+    lines.append('/***** MACROS ****************************************************************/')
+    lines.append('#define %s_MINOR_FRAME    %d' % (guard.strip('_')[:-2], frame))
+    lines.append('#define %s_HYPERPERIOD    %d' % (guard.strip('_')[:-2], frame * len(frames)))
+    lines.append('')
+    lines.append('#endif')
+
+    with open(fileName, mode='w') as file:
+        file.write('\n'.join(lines) + '\n')
+
+
+# Create an configure the argument parser
+argParser = argparse.ArgumentParser(prog='gen_cyclic_schedule', description='Generates the frame table of a cyclic executive')
+argParser.add_argument('filename')
+argParser.add_argument('-o', '--output', required=True, help='Output file name without extension (.c and .h are generated)')
+
+# Parse the commandline arguments
+args = argParser.parse_args()
+
+with open(args.filename, mode='r') as file:
+    config = json.load(file)
+
+config.setdefault('tickMicroseconds', 1000)
+config.setdefault('table', 'gFrameTable')
+tasks = config['tasks']
+
+if len(tasks) == 0:
+    sys.exit('No tasks defined')
+
+for task in tasks:
+    if task['period'] <= 0 or task['wcet'] <= 0:
+        sys.exit('Invalid period or WCET of task %s' % task['function'])
+
+hyperperiod = 1
+for task in tasks:
+    hyperperiod = lcm(hyperperiod, task['period'])
+
+utilization = sum(task['wcet'] / (task['period'] * config['tickMicroseconds']) for task in tasks)
+if utilization > 1.0:
+    sys.exit('Task set not schedulable, utilization %.2f' % utilization)
+
+frames = None
+for frame in frameCandidates(tasks, hyperperiod, config['tickMicroseconds']):
+    frames = assignJobs(tasks, hyperperiod, frame, config['tickMicroseconds'])
+    if frames is not None:
+        break
+
+if frames is None:
+    sys.exit('No feasible frame table found (utilization %.2f)' % utilization)
+
+writeSource(args.output + '.c', args.output + '.h', config, tasks, frame, frames, args.filename)
+writeHeader(args.output + '.h', config, frame, frames)
+
+print('Hyperperiod %d ticks, minor frame %d ticks, %d frames, utilization %.2f'
+      % (hyperperiod, frame, len(frames), utilization))